@@ -1,15 +1,35 @@
 // Include necessary libraries
 #include "DHT.h"
+#include "DHTApparent.h"
+#include <DecimalCodec.h>
 #include <LiquidCrystal.h>
+#include <LiquidCrystalGlyphs.h>
+#include <LiquidCrystalScheduler.h>
 
 // Define delay constants
 #define debounceDelay 100
 #define tempDelay 2000
-#define fanSpeedUpdateDelay 1000
+#define fanDisplayInterval 250
+#define climateDisplayInterval 1000
+
+// Longest line read from the ESP8266 (weather CSV or status message)
+#define serialLineSize 64
+
+// Entries per LCD transmit queue (one per byte sent to the display)
+#define lcdQueueSize 48
+
+// Estimated LCD bus time (us) the displays may use per loop pass
+#define lcdBusBudget 3000
 
 // DHT11 Config
+// Pin 41 has no external interrupt, so poll() times the ~5 ms reply with interrupts off.
+// On pin 2, 3, 18 or 19 it would be captured edge by edge instead (20/21 are I2C).
 #define DHTPIN 41
 #define DHTTYPE DHT11
+#define dhtMaxAge 10000        // Humidity older than this (ms) is not shown
+
+// Run auto mode on apparent temperature (heat index) instead of air temperature
+#define useApparentTemp false
 
 DHT dht(DHTPIN, DHTTYPE);     // Initialize DHT11 sensor
 
@@ -41,6 +61,26 @@ LiquidCrystal lcd(6, 7, 8, 9, 10, 11);         // Display 1: Fan info (fan speed
 LiquidCrystal lcd2(53, 52, 51, 50, 49, 48);    // Display 2: Temperature and humidity
 LiquidCrystal lcd3(47, 46, 45, 44, 43, 42);    // Display 3: Menu
 
+// Display 1 widgets: fan speed bar (row 0) and temperature trend (row 1)
+LiquidCrystalGlyphs lcdGlyphs(lcd);
+LiquidCrystalBar fanBar(lcd, lcdGlyphs, 4, 0, 9);
+LiquidCrystalSparkline tempTrend(lcd, lcdGlyphs, 12, 1, 4);
+
+// Transmit queues drained by the LCD timer interrupt
+uint16_t lcdQueue[lcdQueueSize];
+uint16_t lcd2Queue[lcdQueueSize];
+uint16_t lcd3Queue[lcdQueueSize];
+
+// Redraw scheduling for the three displays
+LiquidCrystalScheduler lcdScheduler(lcdBusBudget);
+uint8_t fanDisplay;
+uint8_t climateDisplay;
+uint8_t menuDisplay;
+
+void renderFanDisplay();
+void renderClimateDisplay();
+void renderMenuDisplay();
+
 // Menu navigation state
 bool enterButtonState = HIGH;
 bool prevEnterButtonState = HIGH;
@@ -65,7 +105,11 @@ int prevMode = 999;
 unsigned long prevTempTime = 0;
 float tempDisplay = 0;
 int prevDisplayState = 999;
-unsigned long fanSpeedUpdate = 0;
+
+// Values shown on the displays
+int fanDisplayMode = 999;
+float climateTempC = 999;
+int climateHumidity = 999;
 
 // Pointer to returned temperature array
 float* readVal;
@@ -82,6 +126,16 @@ void setup() {
   lcd2.begin(16, 2);
   lcd3.begin(16, 2);
 
+  // Queue display output so printing never stalls the control loop
+  lcd.beginAsync(lcdQueue, lcdQueueSize);
+  lcd2.beginAsync(lcd2Queue, lcdQueueSize);
+  lcd3.beginAsync(lcd3Queue, lcdQueueSize);
+
+  // Menu responds to button presses first; fan and climate readouts are throttled
+  menuDisplay = lcdScheduler.add(lcd3, renderMenuDisplay, 0, 2);
+  fanDisplay = lcdScheduler.add(lcd, renderFanDisplay, fanDisplayInterval, 1);
+  climateDisplay = lcdScheduler.add(lcd2, renderClimateDisplay, climateDisplayInterval, 0);
+
   // Set pin modes
   pinMode(fanPin, OUTPUT);
   pinMode(switchPin, INPUT_PULLUP);
@@ -111,25 +165,30 @@ float* readTemperature() {
   if (dataSource) {
     // Read from ESP8266 over Serial1
     if (Serial1.available()) {
-      String data = Serial1.readStringUntil('\n');
-      Serial.println("Received from ESP8266: " + data);
+      char data[serialLineSize];
+      size_t length = Serial1.readBytesUntil('\n', data, sizeof(data) - 1);
+      data[length] = '\0';
+      Serial.print("Received from ESP8266: ");
+      Serial.println(data);
 
       // Check WiFi connection (if data contains space, wifi is disconnected, and visa versa)
-      if (data.indexOf(" ") == -1) {
-        float values[5];
-        int startIndex = 0;
-        int endIndex;
-        int valueIndex = 0;
-
-        // Parse comma-separated data
-        while ((endIndex = data.indexOf(',', startIndex)) != -1) {
-          String value = data.substring(startIndex, endIndex);
-          values[valueIndex++] = value.toFloat();
-          startIndex = endIndex + 1;
+      if (strchr(data, ' ') == NULL) {
+        float values[5] = { 0, 0, 0, 0, 0 };
+        const char* next = data;
+
+        // Parse comma-separated data, each value in hundredths
+        for (int valueIndex = 0; valueIndex < 5; valueIndex++) {
+          int32_t hundredths;
+          if (!decimalParseFixed(next, 2, hundredths, &next)) {
+            break;
+          }
+          values[valueIndex] = hundredths / 100.0;
+          if (*next != ',') {
+            break;
+          }
+          next++;
         }
 
-        values[valueIndex] = data.substring(startIndex).toFloat(); // Last value
-
         // Assign values
         tempC = values[0];
         tempF = values[1];
@@ -138,18 +197,22 @@ float* readTemperature() {
         int windSpeed= values[4];
 
         Serial.println("---------------------------------");
-        Serial.println("Temp C: " + String(tempC));
-        Serial.println("Temp F: " + String(tempF));
-        Serial.println("Humidity: " + String(humidity));
-        Serial.println("Pressure: " + String(pressure));
+        Serial.print("Temp C: ");
+        decimalPrint(Serial, tempC, 2);
+        Serial.print("\nTemp F: ");
+        decimalPrint(Serial, tempF, 2);
+        Serial.print("\nHumidity: ");
+        decimalPrint(Serial, humidity, 2);
+        Serial.println("\nPressure: " + String(pressure));
         Serial.println("Wind Speed: " + String(windSpeed));
         
         returnVal[0] = tempC;
         returnVal[1] = tempF;
         returnVal[2] = humidity;
-        Serial.println("returnVal[0]: " + String(returnVal[0]));
-        Serial.println("returnVal[1]: " + String(returnVal[1]));
-        Serial.println("returnVal[2]: " + String(returnVal[2]));
+      }
+      else if (strncmp(data, "WiFi Connected", 14) == 0) {
+        // Link is back up; weather data follows shortly, keep the last values until then
+        Serial.println("WiFi reconnected");
       }
       else {
         // Wifi is disconnected or invalid data
@@ -171,7 +234,8 @@ float* readTemperature() {
     float voltage = sum * (5.0 / 1023.0);
     tempC = (voltage - 0.5) * 100;           // Convert to Celsius
     tempF = tempC * 9.0 / 5.0 + 32.0;        // Convert to Fahrenheit
-    humidity = dht.readHumidity();           // Read humidity
+    const DHTSample &reading = dht.sample(); // Latest DHT11 humidity
+    humidity = reading.stale(dhtMaxAge) ? 999 : reading.humidity;
 
     returnVal[0] = tempC;
     returnVal[1] = tempF;
@@ -184,6 +248,9 @@ float* readTemperature() {
 void loop() {
   unsigned long startTime = millis();
 
+  // Refresh the DHT11 reading in the background; dht.sample() never waits on the sensor
+  dht.poll();
+
   // -------------------- Mode Switch Handling --------------------
 
   int switchState = digitalRead(switchPin); // Read current switch state (manual/auto)
@@ -235,6 +302,12 @@ void loop() {
   if (mode == 0) {
     readVal = readTemperature();
     float readTempC = readVal[0];
+#if useApparentTemp
+    // Heat index from the lookup table, cheap enough for every pass
+    if (readTempC != 999 && readVal[2] != 999) {
+      readTempC = dhtHeatIndex10((int)(readTempC * 10), (int)(readVal[2] * 10)) / 10.0;
+    }
+#endif
     // If valid reading, update temperature
     temperature = readTempC == 999 ? temperature : readTempC;
 
@@ -512,9 +585,8 @@ void loop() {
     }
   }
 
-  // -------------------- FAN STATUS DISPLAY (Display 1) --------------------
+  // -------------------- FAN STATUS (Display 1) --------------------
 
-  String modeText = (mode == 0) ? "Auto" : "Manual";
   fanSpeedVal = fanSpeedVal > 100 ? 100 : fanSpeedVal;
 
   // Transistor on/off based on speed
@@ -526,201 +598,220 @@ void loop() {
 
   fanSpeedVal = ((int) (fanSpeedVal / 5)) * 5;
 
-  // Fan speed & mode display logic
   if (mode != prevMode || fanSpeedVal != prevFanSpeedVal) {
     prevMode = mode;
     prevFanSpeedVal = fanSpeedVal;
-
-    String fanSpeedText = "Fan Speed: " + String(fanSpeedVal);
-    if (fanSpeed < 10) fanSpeedText = "Fan Speed:  " + String(fanSpeedVal);
-
-    if (mode == 1) {
-      lcd.clear();
-      lcd.setCursor(0, 0);
-      lcd.print(fanSpeedText);
-      lcd.setCursor(0, 1);
-      lcd.print("Mode: ");
-      lcd.print(modeText);
-    } 
-    else if (mode == 0 && millis() - fanSpeedUpdate > fanSpeedUpdateDelay && fanSpeedVal != 100 && fanSpeedVal != 0) {
-      fanSpeedUpdate = millis();
-      lcd.clear();
-      lcd.setCursor(0, 0);
-      lcd.print(fanSpeedText);
-      lcd.setCursor(0, 1);
-      lcd.print("Mode: ");
-      lcd.print(modeText);
-    }
-    else if (mode == 0 && fanSpeedVal == 100 || fanSpeedVal == 0) {
-      lcd.clear();
-      lcd.setCursor(0, 0);
-      lcd.print(fanSpeedText);
-      lcd.setCursor(0, 1);
-      lcd.print("Mode: ");
-      lcd.print(modeText);
-    }
+    lcdScheduler.invalidate(fanDisplay);
   }
 
-  // -------------------- AMBIENT TEMPERATURE & HUMIDITY DISPLAY (Display 2) --------------------
+  // -------------------- AMBIENT TEMPERATURE & HUMIDITY (Display 2) --------------------
 
   if (millis() - prevTempTime >= tempDelay) {
     prevTempTime = millis();
 
     Serial.println("Calling readTemperature for display!!!");
     readVal = readTemperature();
-    float readTempC = readVal[0];
-    int humidity = readVal[2];
-    Serial.println("Displaying vals: " + String(readTempC) + " " + String(humidity));
-    tempDisplay = readTempC == 999 ? temperature : readTempC;
-
-    if (readTempC == 999 && humidity == 999) {
-      lcd2.clear();
-      lcd2.setCursor(0, 0);
-      lcd2.print("WiFi");
-      lcd2.setCursor(0, 1);
-      lcd2.print("Disconnected");
-    } else {
-      lcd2.clear();
-      lcd2.setCursor(0, 0);
-      lcd2.print("Temp: ");
-      lcd2.print(tempDisplay);
-      lcd2.print(" C");
-      lcd2.setCursor(0, 1);
-      lcd2.print("Humidity: ");
-      lcd2.print(humidity);
-      lcd2.print("%");
+    climateTempC = readVal[0];
+    climateHumidity = readVal[2];
+    Serial.println("Displaying vals: " + String(climateTempC) + " " + String(climateHumidity));
+    tempDisplay = climateTempC == 999 ? temperature : climateTempC;
+
+    // Temperature trend on Display 1, in tenths of a degree
+    if (climateTempC != 999) {
+      tempTrend.push((int)(climateTempC * 10));
+      lcdScheduler.invalidate(fanDisplay);
     }
+    lcdScheduler.invalidate(climateDisplay);
   }
 
-  // -------------------- MENU DISPLAY (Display 3) --------------------
+  // -------------------- MENU (Display 3) --------------------
 
-  if (state != 3 && state != 5 && state != prevDisplayState) {
+  if (state != prevDisplayState ||
+      (state == 3 && setMaxTemp != prevSetMaxTemp) ||
+      (state == 5 && setMinTemp != prevSetMinTemp)) {
     prevDisplayState = state;
-    if (state == 0) {
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print("> Data Source");
-    } 
-    else if (state == 1) {
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print("> Range Config");
-      lcd3.setCursor(0, 1);
-      lcd3.print("  Data Source");
-    }
-    else if (state == 2) {
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print("> Max Temp");
-      lcd3.setCursor(0, 1);
-      lcd3.print("  Min Temp");
-    }
-    else if (state == 4) {
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print("  Max Temp");
-      lcd3.setCursor(0, 1);
-      lcd3.print("> Min Temp");
-    }
-    else if (state == 6) {
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print("  Range Config");
-      lcd3.setCursor(0, 1);
-      lcd3.print("> Data Source");
-    }
-    else if (state == 7) {
-      String weatherString = "";
-      String localString = "";
-
-      if (dataSource) {
-        localString += ">  Local Sensor";
-        weatherString += "  *Weather API";
-      } else {
-        localString = "> *Local Sensor";
-        weatherString = "   Weather API";
-      }
+    prevSetMaxTemp = setMaxTemp;
+    prevSetMinTemp = setMinTemp;
+    lcdScheduler.invalidate(menuDisplay);
+  }
 
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print(localString);
-      lcd3.setCursor(0, 1);
-      lcd3.print(weatherString);
-    }
-    else if (state == 8) {
-      String weatherString = "";
-      String localString = "";
-      
-      if (dataSource) {
-        localString += "   Local Sensor";
-        weatherString += "> *Weather API";
-      } else {
-        localString = "  *Local Sensor";
-        weatherString = ">  Weather API";
-      }
+  // Redraw whatever changed, menu first, within the per-pass bus budget
+  lcdScheduler.run();
+}
 
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print(localString);
-      lcd3.setCursor(0, 1);
-      lcd3.print(weatherString);
-    }
-    else if (state == 9) {
-      String weatherString = "";
-      String localString = "";
-
-      if (dataSource) {
-        localString += ">  Local Sensor";
-        weatherString += "  *Weather API";
-      } else {
-        localString = "> *Local Sensor";
-        weatherString = "   Weather API";
-      }
+// -------------------- Display Render Functions --------------------
+// Called from lcdScheduler.run() once a display is dirty and its interval has passed
+
+void renderFanDisplay() {
+  // Static labels are only redrawn when the mode changes
+  if (mode != fanDisplayMode) {
+    fanDisplayMode = mode;
+    lcd.clear();
+    lcd.setCursor(0, 0);
+    lcd.print("Fan");
+    lcd.setCursor(0, 1);
+    lcd.print("Mode: ");
+    lcd.print((mode == 0) ? "Auto" : "Manual");
+    fanBar.invalidate();
+    tempTrend.invalidate();
+  }
 
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print(localString);
-      lcd3.setCursor(0, 1);
-      lcd3.print(weatherString);
-    }
-    else if (state == 10) {
-      String weatherString = "";
-      String localString = "";
-      
-      if (dataSource) {
-        localString += "   Local Sensor";
-        weatherString += "> *Weather API";
-      } else {
-        localString = "  *Local Sensor";
-        weatherString = ">  Weather API";
-      }
+  // Fan speed bar & value
+  fanBar.draw(fanSpeedVal, 100);
+  lcd.setCursor(13, 0);
+  if (fanSpeedVal < 100) lcd.print(" ");
+  if (fanSpeedVal < 10) lcd.print(" ");
+  lcd.print(fanSpeedVal);
+
+  tempTrend.draw();
+}
 
-      lcd3.clear();
-      lcd3.setCursor(0, 0);
-      lcd3.print(localString);
-      lcd3.setCursor(0, 1);
-      lcd3.print(weatherString);
+void renderClimateDisplay() {
+  if (climateTempC == 999 && climateHumidity == 999) {
+    lcd2.clear();
+    lcd2.setCursor(0, 0);
+    lcd2.print("WiFi");
+    lcd2.setCursor(0, 1);
+    lcd2.print("Disconnected");
+  } else {
+    lcd2.clear();
+    lcd2.setCursor(0, 0);
+    lcd2.print("Temp: ");
+    decimalPrint(lcd2, tempDisplay, 2);
+    lcd2.print(" C");
+    lcd2.setCursor(0, 1);
+    lcd2.print("Humidity: ");
+    if (climateHumidity == 999) {
+      lcd2.print("--");
+    } else {
+      lcd2.print(climateHumidity);
     }
+    lcd2.print("%");
   }
+}
 
-  // -------------------- Live Value Adjustment (MAX/MIN Temp) Screens --------------------
-
-  if (state == 3 && setMaxTemp != prevSetMaxTemp) {
-    prevSetMaxTemp = setMaxTemp;
+void renderMenuDisplay() {
+  if (state == 0) {
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print("> Data Source");
+  } 
+  else if (state == 1) {
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print("> Range Config");
+    lcd3.setCursor(0, 1);
+    lcd3.print("  Data Source");
+  }
+  else if (state == 2) {
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print("> Max Temp");
+    lcd3.setCursor(0, 1);
+    lcd3.print("  Min Temp");
+  }
+  else if (state == 3) {
+    // Live value adjustment (MAX Temp)
     lcd3.clear();
     lcd3.setCursor(0, 0);
     lcd3.print("Max Temp: ");
-    lcd3.print(setMaxTemp);
+    decimalPrint(lcd3, setMaxTemp, 2);
     lcd3.setCursor(0, 1);
     lcd3.print("ENTER to confirm");
   }
-  else if (state == 5 && setMinTemp != prevSetMinTemp) {
-    prevSetMinTemp = setMinTemp;
+  else if (state == 4) {
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print("  Max Temp");
+    lcd3.setCursor(0, 1);
+    lcd3.print("> Min Temp");
+  }
+  else if (state == 5) {
+    // Live value adjustment (MIN Temp)
     lcd3.clear();
     lcd3.setCursor(0, 0);
     lcd3.print("Min Temp: ");
-    lcd3.print(setMinTemp);
+    decimalPrint(lcd3, setMinTemp, 2);
     lcd3.setCursor(0, 1);
     lcd3.print("ENTER to confirm");
   }
+  else if (state == 6) {
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print("  Range Config");
+    lcd3.setCursor(0, 1);
+    lcd3.print("> Data Source");
+  }
+  else if (state == 7) {
+    String weatherString = "";
+    String localString = "";
+
+    if (dataSource) {
+      localString += ">  Local Sensor";
+      weatherString += "  *Weather API";
+    } else {
+      localString = "> *Local Sensor";
+      weatherString = "   Weather API";
+    }
+
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print(localString);
+    lcd3.setCursor(0, 1);
+    lcd3.print(weatherString);
+  }
+  else if (state == 8) {
+    String weatherString = "";
+    String localString = "";
+    
+    if (dataSource) {
+      localString += "   Local Sensor";
+      weatherString += "> *Weather API";
+    } else {
+      localString = "  *Local Sensor";
+      weatherString = ">  Weather API";
+    }
+
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print(localString);
+    lcd3.setCursor(0, 1);
+    lcd3.print(weatherString);
+  }
+  else if (state == 9) {
+    String weatherString = "";
+    String localString = "";
+
+    if (dataSource) {
+      localString += ">  Local Sensor";
+      weatherString += "  *Weather API";
+    } else {
+      localString = "> *Local Sensor";
+      weatherString = "   Weather API";
+    }
+
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print(localString);
+    lcd3.setCursor(0, 1);
+    lcd3.print(weatherString);
+  }
+  else if (state == 10) {
+    String weatherString = "";
+    String localString = "";
+    
+    if (dataSource) {
+      localString += "   Local Sensor";
+      weatherString += "> *Weather API";
+    } else {
+      localString = "  *Local Sensor";
+      weatherString = ">  Weather API";
+    }
+
+    lcd3.clear();
+    lcd3.setCursor(0, 0);
+    lcd3.print(localString);
+    lcd3.setCursor(0, 1);
+    lcd3.print(weatherString);
+  }
 }
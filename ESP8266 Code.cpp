@@ -1,6 +1,8 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266HTTPClient.h>
+#include <HTTPSession.h>
 #include <Arduino_JSON.h>
+#include <DecimalCodec.h>
 
 // WiFi credentials
 const char* ssid = "myHotspot";
@@ -15,23 +17,56 @@ String countryCode = "US";
 unsigned long lastTime = 0;
 unsigned long timerDelay = 20000;  // 20 seconds
 
-String jsonBuffer;
+// Weather fields read from the reply, and where each one is in the JSON
+struct WeatherNow {
+  double temp;       // Kelvin
+  int humidity;      // %
+  int pressure;      // hPa
+  double windSpeed;  // m/s
+};
+const JSONField weatherSchema[] = {
+  JSON_FIELD(WeatherNow, temp, "main.temp"),
+  JSON_FIELD(WeatherNow, humidity, "main.humidity"),
+  JSON_FIELD(WeatherNow, pressure, "main.pressure"),
+  JSON_FIELD(WeatherNow, windSpeed, "wind.speed"),
+};
+WeatherNow weather;
+JSONDecoder<WeatherNow> weatherDecoder(weatherSchema, 4);
+
+// Weather session: one HTTP client and TCP connection kept open across polls
+WiFiClient weatherClient;
+HTTPClient weatherHttp;
+HTTPSession<HTTPClient, WiFiClient> weatherSession(weatherHttp, weatherClient);
+
+// WiFi connection manager settings
+#define wifiConnectTimeout 10000   // ms allowed for one connection attempt
+#define wifiBackoffMin 500         // ms before the first retry
+#define wifiBackoffMax 60000       // longest wait between retries
+
+// WiFi connection state (0 = waiting to retry, 1 = connecting, 2 = connected)
+#define WIFI_WAITING 0
+#define WIFI_CONNECTING 1
+#define WIFI_CONNECTED 2
+int wifiState = WIFI_WAITING;
+unsigned long wifiStateTime = 0;
+unsigned long wifiBackoff = 0;     // 0 = try right away
+
+// Access point of the last good connection, to reconnect without a scan
+uint8_t wifiBssid[6];
+int32_t wifiChannel = 0;
+bool wifiCached = false;
 
 void setup() {
   // Start serial communication for debugging
   Serial.begin(115200);
   Serial1.begin(115200);   // Communication with Arduino Uno
 
-  // Connect to WiFi
-  WiFi.begin(ssid, password);
-  Serial.println("Connecting to WiFi...");
-  while(WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-  }
-  Serial.println("");
-  Serial.print("Connected to WiFi, IP Address: ");
-  Serial.println(WiFi.localIP());
+  // WiFi is connected from loop() by updateWiFi(), so the serial link runs right away.
+  // Reconnects are handled there too instead of by the SDK.
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  randomSeed(ESP.getChipId());
 
   // Set timer for 20 seconds
   int sec = timerDelay / 1000;
@@ -39,34 +74,38 @@ void setup() {
 }
 
 void loop() {
+  // Keep the WiFi connection up without blocking
+  updateWiFi();
+
   // Check if it's time to request new weather data
   if ((millis() - lastTime) > timerDelay) {
     // Only fetch data if WiFi is connected
-    if (WiFi.status() == WL_CONNECTED) {
-      // Construct the OpenWeatherMap API URL with the city and API key
-      String serverPath = "http://api.openweathermap.org/data/2.5/weather?q=" + city + "," + countryCode + "&APPID=" + openWeatherMapApiKey;
-      
-      // Send GET request to OpenWeatherMap and receive JSON response
-      jsonBuffer = httpGETRequest(serverPath.c_str());
-      JSONVar myObject = JSON.parse(jsonBuffer);
-  
-      // If JSON parsing fails, print an error and return
-      if (JSON.typeof(myObject) == "undefined") {
-        Serial.println("Parsing input failed!");
+    if (wifiState == WIFI_CONNECTED) {
+      // Send GET request to OpenWeatherMap and decode the JSON response into weather
+      // If the request failed or the reply is missing any of the fields, return (the
+      // error was printed) and wait a full interval before asking again
+      if (!weatherGETRequest()) {
+        lastTime = millis();
         return;
       }
     
-      // Extract temperature (in Kelvin), humidity, pressure, and wind speed from JSON response
-      double tempK = myObject["main"]["temp"];
+      // Temperature (in Kelvin), humidity, pressure, and wind speed from the JSON response
+      double tempK = weather.temp;
       double tempC = tempK - 273.15;                       // Convert to Celsius
       double tempF = (tempK - 273.15) * 9.0 / 5.0 + 32.0;  // Convert to Fahrenheit
 
       // Format weather data as a comma-separated string
-      String weatherData = String(tempC, 2) + "," +
-        String(tempF, 2) + "," +
-        String((int)myObject["main"]["humidity"]) + "," +
-        String((int)myObject["main"]["pressure"]) + "," +
-        String((double)myObject["wind"]["speed"], 2);
+      char weatherData[5 * DECIMAL_BUFFER_SIZE];
+      char* p = weatherData;
+      p += decimalFormat(p, tempC, 2);
+      *p++ = ',';
+      p += decimalFormat(p, tempF, 2);
+      *p++ = ',';
+      p += decimalFormatFixed(p, weather.humidity, 0);
+      *p++ = ',';
+      p += decimalFormatFixed(p, weather.pressure, 0);
+      *p++ = ',';
+      decimalFormat(p, weather.windSpeed, 2);
 
       // Send weather data to Arduino Uno via Serial1
       Serial1.println(weatherData);
@@ -75,7 +114,8 @@ void loop() {
       Serial.println(weatherData);
     }
     else {
-      // Print message if WiFi is disconnected
+      // Let the Arduino know there is no weather data
+      Serial1.println("WiFi Disconnected");
       Serial.println("WiFi Disconnected");
     }
     // Update the last time to the current time
@@ -83,32 +123,106 @@ void loop() {
   }
 }
 
-// Function to send GET request to the server and return the response payload
-String httpGETRequest(const char* serverName) {
-  WiFiClient client;
-  HTTPClient http;
-    
-  // Initiate the HTTP request
-  http.begin(client, serverName);
-  
-  // Send GET request
-  int httpResponseCode = http.GET();
-  
-  // Default empty JSON payload in case of error
-  String payload = "{}"; 
-  
-  // If the response code is positive, retrieve the response content
-  if (httpResponseCode > 0) {
-    payload = http.getString();
+// Non-blocking WiFi connection manager, called every loop.
+// Retries back off exponentially (with some random jitter) up to wifiBackoffMax.
+// After a connection drops, the first retry goes straight to the cached access
+// point and channel, which takes a few hundred ms instead of a full scan.
+// Link changes are sent to the Arduino as "WiFi Connected" / "WiFi Disconnected".
+void updateWiFi() {
+  unsigned long now = millis();
+
+  if (wifiState == WIFI_WAITING) {
+    if (now - wifiStateTime >= wifiBackoff) {
+      if (wifiCached) {
+        Serial.println("Reconnecting to WiFi on channel " + String(wifiChannel) + "...");
+        WiFi.begin(ssid, password, wifiChannel, wifiBssid);
+      } else {
+        Serial.println("Connecting to WiFi...");
+        WiFi.begin(ssid, password);
+      }
+      wifiState = WIFI_CONNECTING;
+      wifiStateTime = now;
+    }
+  }
+  else if (wifiState == WIFI_CONNECTING) {
+    wl_status_t status = WiFi.status();
+
+    if (status == WL_CONNECTED) {
+      Serial.print("Connected to WiFi, IP Address: ");
+      Serial.println(WiFi.localIP());
+      Serial1.println("WiFi Connected");
+
+      // Remember the access point for the next reconnect
+      memcpy(wifiBssid, WiFi.BSSID(), sizeof(wifiBssid));
+      wifiChannel = WiFi.channel();
+      wifiCached = true;
+
+      wifiState = WIFI_CONNECTED;
+      wifiBackoff = 0;
+
+      // Fetch weather data right away
+      lastTime = now - timerDelay - 1;
+    }
+    else if (now - wifiStateTime > wifiConnectTimeout ||
+             status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL) {
+      // The access point may have moved channel, so scan on the next try
+      wifiCached = false;
+      WiFi.disconnect();
+
+      wifiBackoff = wifiBackoff == 0 ? wifiBackoffMin : wifiBackoff * 2;
+      if (wifiBackoff > wifiBackoffMax) {
+        wifiBackoff = wifiBackoffMax;
+      }
+      wifiBackoff += random(wifiBackoff / 4 + 1);
+      Serial.println("WiFi connection failed, retrying in " + String(wifiBackoff) + " ms");
+
+      wifiState = WIFI_WAITING;
+      wifiStateTime = now;
+    }
+  }
+  else if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("WiFi connection lost");
+    Serial1.println("WiFi Disconnected");
+    wifiState = WIFI_WAITING;
+    wifiStateTime = now;
   }
-  else {
+}
+
+// Function to send the weather GET request and decode the reply into weather.
+// The session keeps its connection alive between polls and retries once on a
+// new one when the server has closed it (see HTTPSession.h).
+// The body is scanned as it arrives instead of being read into a String and
+// parsed into a tree; parsing stops once all the fields have been found.
+// Returns true if all of them were found with the right types.
+bool weatherGETRequest() {
+  if (!weatherSession.ready()) {
+    // Construct the OpenWeatherMap API URL with the city and API key, once
+    weatherSession.begin("http://api.openweathermap.org/data/2.5/weather?q=" + city + "," + countryCode + "&APPID=" + openWeatherMapApiKey);
+  }
+
+  // Send GET request and scan the response content as it arrives
+  // (the rest of the body after the last field is still read, but not parsed,
+  // which leaves the connection ready for the next request)
+  weatherDecoder.begin(weather);
+  int httpResponseCode = weatherSession.GET(&weatherDecoder);
+
+  if (httpResponseCode <= 0) {
     // Print error code if the request fails
     Serial.print("Error code: ");
     Serial.println(httpResponseCode);
   }
-  // End the HTTP request
-  http.end();
 
-  // Return the response payload
-  return payload;
+  Serial.println("Weather request took " + String(weatherSession.latency()) + " ms, TCP connections: " + String(weatherSession.connections()));
+
+  uint8_t error = weatherDecoder.end();
+  if (error != JSON_DECODE_OK) {
+    Serial.print("Parsing input failed! Error " + String(error));
+    if (weatherDecoder.errorPath()) {
+      Serial.print(" at " + String(weatherDecoder.errorPath()));
+    }
+    Serial.println();
+    return false;
+  }
+
+  return true;
 }
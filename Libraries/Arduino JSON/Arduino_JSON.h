@@ -21,5 +21,11 @@
 #define _ARDUINO_JSON_H_
 
 #include "JSON.h"
+#include "JSONArena.h"
+#include "JSONIndex.h"
+#include "JSONSaxParser.h"
+#include "JSONPathScanner.h"
+#include "JSONDecoder.h"
+#include "JSONWriter.h"
 
 #endif
@@ -25,6 +25,8 @@
 
 #include "cjson/cJSON.h"
 
+#include "JSONArena.h"
+
 static int jsonAllocations = 0;
 
 void* JSON_malloc(size_t sz)
@@ -64,7 +66,7 @@ JSONClass::JSONClass()
     JSON_free
   };
 
-  cJSON_InitHooks(&hooks);
+  JSONArena::setHooks(&hooks);
 #endif
 }
 
@@ -82,6 +84,11 @@ JSONVar JSONClass::parse(const String& s)
   return JSONVar::parse(s);
 }
 
+JSONVar JSONClass::parseInPlace(char* s)
+{
+  return JSONVar::parseInPlace(s);
+}
+
 String JSONClass::stringify(const JSONVar& value)
 {
   return JSONVar::stringify(value);
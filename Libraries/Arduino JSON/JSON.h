@@ -32,6 +32,11 @@ public:
   JSONVar parse(const char* s);
   JSONVar parse(const String& s);
 
+  // Parses s in place: keys and strings are decoded into s and the document
+  // points at them instead of holding copies, so s must outlive it and
+  // every view into it.  Copies made from it own their keys and strings.
+  JSONVar parseInPlace(char* s);
+
   String stringify(const JSONVar& value);
 
   String typeof(const JSONVar& value);
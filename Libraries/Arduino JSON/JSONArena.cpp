@@ -0,0 +1,151 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "cjson/cJSON.h"
+
+#include "JSONArena.h"
+#include "JSONIndex.h"
+
+JSONArena* JSONArena::_active = NULL;
+void* (*JSONArena::_baseMalloc)(size_t) = malloc;
+void (*JSONArena::_baseFree)(void*) = free;
+
+// Install cJSON hooks that stay in place beneath every arena.  NULL, as
+// for cJSON_InitHooks(), goes back to malloc() and free().
+void JSONArena::setHooks(struct cJSON_Hooks* hooks)
+{
+  _baseMalloc = (hooks && hooks->malloc_fn) ? hooks->malloc_fn : malloc;
+  _baseFree = (hooks && hooks->free_fn) ? hooks->free_fn : free;
+
+  // an active arena keeps its own hooks until it goes
+  if (_active == NULL) {
+    cJSON_InitHooks(hooks);
+  }
+}
+
+JSONArena::JSONArena(void* buffer, size_t size) :
+  _buffer((uint8_t*)buffer),
+  _size(size),
+  _used(0),
+  _last(size),
+  _highWater(0),
+  _allocations(0),
+  _overflows(0),
+  _previous(_active)
+{
+  // start on an aligned boundary
+  size_t skew = (uintptr_t)_buffer % JSON_ARENA_ALIGN;
+
+  if (skew) {
+    skew = JSON_ARENA_ALIGN - skew;
+    _buffer += skew;
+    _size = (_size > skew) ? _size - skew : 0;
+    _last = _size;
+  }
+
+  _active = this;
+  install();
+}
+
+JSONArena::~JSONArena()
+{
+  // the buffer may be reused for other nodes at the same addresses
+  JSONIndex::invalidate();
+
+  _active = _previous;
+
+  if (_active) {
+    _active->install();
+  } else {
+    struct cJSON_Hooks hooks = {
+      _baseMalloc,
+      _baseFree
+    };
+
+    cJSON_InitHooks(&hooks);
+  }
+}
+
+void JSONArena::install()
+{
+  struct cJSON_Hooks hooks = {
+    arenaMalloc,
+    arenaFree
+  };
+
+  cJSON_InitHooks(&hooks);
+}
+
+void* JSONArena::allocate(size_t size)
+{
+  size_t rounded = (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+
+  _allocations++;
+
+  if (rounded > _size - _used) {
+    _overflows++;
+    return _baseMalloc(size);
+  }
+
+  _last = _used;
+  _used += rounded;
+  if (_used > _highWater) {
+    _highWater = _used;
+  }
+
+  return _buffer + _last;
+}
+
+bool JSONArena::release(void* ptr)
+{
+  uint8_t* p = (uint8_t*)ptr;
+
+  if (p < _buffer || p >= _buffer + _size) {
+    return false;
+  }
+
+  // only the newest block can be taken back, e.g. a temporary print buffer
+  if (p == _buffer + _last) {
+    _used = _last;
+    _last = _size;
+  }
+  return true;
+}
+
+void* JSONArena::arenaMalloc(size_t size)
+{
+  return _active->allocate(size);
+}
+
+void JSONArena::arenaFree(void* ptr)
+{
+  if (ptr == NULL) {
+    return;
+  }
+
+  // the block may belong to an enclosing arena, or have come from the hooks
+  // beneath them
+  for (JSONArena* arena = _active; arena != NULL; arena = arena->_previous) {
+    if (arena->release(ptr)) {
+      return;
+    }
+  }
+
+  _baseFree(ptr);
+}
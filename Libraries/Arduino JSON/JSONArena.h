@@ -0,0 +1,98 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_ARENA_H_
+#define _JSON_ARENA_H_
+
+#include <Arduino.h>
+
+struct cJSON_Hooks;
+
+#ifdef __BIGGEST_ALIGNMENT__
+#define JSON_ARENA_ALIGN __BIGGEST_ALIGNMENT__
+#else
+#define JSON_ARENA_ALIGN 8
+#endif
+
+// Bump allocator for cJSON, active for the lifetime of the object.
+//
+// While a JSONArena is in scope every cJSON allocation (parse, create,
+// stringify) is carved out of the caller's buffer instead of the heap, and
+// frees are no-ops, apart from the most recent block, which is handed back.
+// The whole buffer is released at once when the arena goes out of scope,
+// so parsing a document leaves no holes in the heap.  Requests that don't
+// fit fall back to malloc() and are counted in overflows().
+//
+//   static uint8_t buffer[2048];
+//   {
+//     JSONArena arena(buffer, sizeof(buffer));
+//     JSONVar doc = JSON.parse(s);
+//     ...
+//     Serial.println(arena.highWater());   // bytes the buffer needs
+//   }
+//
+// Every JSONVar that uses the arena has to be destroyed before it: declare
+// the arena first in the scope, and don't copy documents out of it.
+// Arenas may nest; the innermost one is used.
+//
+// cJSON can't report which hooks are installed, so allocation hooks meant
+// to stay in place around arenas (such as JSON_HOOKS in JSON.cpp) must be
+// set with JSONArena::setHooks() rather than cJSON_InitHooks().  When an
+// arena goes, the hooks it replaced (the enclosing arena's, or these) are
+// reinstalled, and requests an arena can't hold are passed on to them.
+class JSONArena {
+public:
+  JSONArena(void* buffer, size_t size);
+  ~JSONArena();
+
+  size_t size() const { return _size; }
+  size_t used() const { return _used; }
+  size_t highWater() const { return _highWater; }
+  unsigned int allocations() const { return _allocations; }
+  unsigned int overflows() const { return _overflows; }
+
+  static void setHooks(struct cJSON_Hooks* hooks);
+
+private:
+  JSONArena(const JSONArena&);
+  void operator=(const JSONArena&);
+
+  void* allocate(size_t size);
+  bool release(void* ptr);
+  void install();
+
+  static void* arenaMalloc(size_t size);
+  static void arenaFree(void* ptr);
+
+  uint8_t* _buffer;
+  size_t _size;
+  size_t _used;
+  size_t _last;            // offset of the most recent block
+  size_t _highWater;
+  unsigned int _allocations;
+  unsigned int _overflows; // requests passed on to the saved hooks
+  JSONArena* _previous;
+
+  static JSONArena* _active;
+  // hooks outside all arenas, see setHooks()
+  static void* (*_baseMalloc)(size_t);
+  static void (*_baseFree)(void*);
+};
+
+#endif
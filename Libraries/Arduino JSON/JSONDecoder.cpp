@@ -0,0 +1,192 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <float.h>
+#include <limits.h>
+
+#include <DecimalCodec.h>
+
+#include "JSONDecoder.h"
+
+// Converting a double outside the target's range is undefined, so every
+// number is checked first.  The bounds are powers of two, exact even where
+// double is a 32-bit float: a long takes [-2^31, 2^31), an int [-2^15, 2^15)
+// on AVR, and an unsigned long (-1, 2^32).
+static bool fitsInt(double number, double min)
+{
+  return number >= min && number < -min;
+}
+
+static bool fitsUnsigned(double number, double min)
+{
+  return number > -1.0 && number < -2.0 * min;
+}
+
+JSONDecoderBase::JSONDecoderBase(const JSONField* fields, uint8_t count) :
+  _fields(fields),
+  _count(count > JSON_DECODE_MAX ? JSON_DECODE_MAX : count),
+  _target(NULL),
+  _found(0),
+  _error(JSON_DECODE_OK),
+  _errorField(-1)
+{
+}
+
+void JSONDecoderBase::start(void* target)
+{
+  reset();
+
+  _target = target;
+  _found = 0;
+  _error = JSON_DECODE_OK;
+  _errorField = -1;
+}
+
+uint8_t JSONDecoderBase::end()
+{
+  if (_error != JSON_DECODE_OK) {
+    return _error;
+  }
+
+  if (failed()) {
+    _error = JSON_DECODE_SYNTAX;
+    return _error;
+  }
+
+  // stop() ends the scan early once every field is in; anything else
+  // still scanning means the input was cut off
+  if (scanning() && _found != (uint16_t)((1UL << _count) - 1)) {
+    _error = JSON_DECODE_INCOMPLETE;
+    return _error;
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_fields[i].required && !(_found & (1U << i))) {
+      _error = JSON_DECODE_MISSING;
+      _errorField = i;
+      return _error;
+    }
+  }
+
+  return _error;
+}
+
+const char* JSONDecoderBase::errorPath() const
+{
+  return (_errorField >= 0) ? _fields[_errorField].path : NULL;
+}
+
+void JSONDecoderBase::value(const char* path, const char* text, uint8_t type)
+{
+  for (uint8_t i = 0; i < _count; i++) {
+    if ((_found & (1U << i)) || strcmp(path, _fields[i].path) != 0) {
+      continue;
+    }
+
+    uint8_t error = store(_fields[i], text, type);
+
+    if (error != JSON_DECODE_OK) {
+      _error = error;
+      _errorField = i;
+      stop();
+      return;
+    }
+
+    _found |= (1U << i);
+    if (_found == (uint16_t)((1UL << _count) - 1)) {
+      stop();
+    }
+    return;
+  }
+}
+
+uint8_t JSONDecoderBase::store(const JSONField& field, const char* text, uint8_t type)
+{
+  void* member = (uint8_t*)_target + field.offset;
+
+  switch (field.type) {
+    case JSON_FIELD_BOOL:
+      if (type != JSON_SCAN_LITERAL || text[0] == 'n') {
+        return JSON_DECODE_TYPE;
+      }
+      *(bool*)member = (text[0] == 't');
+      return JSON_DECODE_OK;
+
+    case JSON_FIELD_STRING: {
+      if (type != JSON_SCAN_STRING) {
+        return JSON_DECODE_TYPE;
+      }
+      char* s = (char*)member;
+
+      strncpy(s, text, field.size - 1);
+      s[field.size - 1] = '\0';
+      return JSON_DECODE_OK;
+    }
+  }
+
+  if (type != JSON_SCAN_NUMBER) {
+    return JSON_DECODE_TYPE;
+  }
+
+  double number = decimalParse(text);
+
+  // e.g. 1e999, which strtod() takes to infinity
+  if (isnan(number) || isinf(number)) {
+    return JSON_DECODE_RANGE;
+  }
+
+  switch (field.type) {
+    case JSON_FIELD_DOUBLE:
+      *(double*)member = number;
+      break;
+
+    case JSON_FIELD_FLOAT:
+      if (fabs(number) > FLT_MAX) {
+        return JSON_DECODE_RANGE;
+      }
+      *(float*)member = number;
+      break;
+
+    case JSON_FIELD_INT:
+      if (!fitsInt(number, INT_MIN)) {
+        return JSON_DECODE_RANGE;
+      }
+      *(int*)member = (int)number;
+      break;
+
+    case JSON_FIELD_LONG:
+      if (!fitsInt(number, LONG_MIN)) {
+        return JSON_DECODE_RANGE;
+      }
+      *(long*)member = (long)number;
+      break;
+
+    case JSON_FIELD_ULONG:
+      if (!fitsUnsigned(number, LONG_MIN)) {
+        return JSON_DECODE_RANGE;
+      }
+      *(unsigned long*)member = (unsigned long)number;
+      break;
+
+    default:
+      return JSON_DECODE_TYPE;
+  }
+
+  return JSON_DECODE_OK;
+}
@@ -0,0 +1,135 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_DECODER_H_
+#define _JSON_DECODER_H_
+
+#include <Arduino.h>
+#include <stddef.h>
+
+#include "JSONPathScanner.h"
+
+#define JSON_DECODE_MAX 16   // fields per schema
+
+// Member types a schema can bind to
+#define JSON_FIELD_DOUBLE 0
+#define JSON_FIELD_FLOAT 1
+#define JSON_FIELD_INT 2
+#define JSON_FIELD_LONG 3
+#define JSON_FIELD_ULONG 4
+#define JSON_FIELD_BOOL 5
+#define JSON_FIELD_STRING 6  // char[N], truncated to fit
+
+// Results of JSONDecoder::end()
+#define JSON_DECODE_OK 0
+#define JSON_DECODE_SYNTAX 1      // malformed document
+#define JSON_DECODE_INCOMPLETE 2  // input ended inside the document
+#define JSON_DECODE_MISSING 3     // a required field was not in the document
+#define JSON_DECODE_TYPE 4        // a field had the wrong JSON type
+#define JSON_DECODE_RANGE 5       // a number doesn't fit its member's type
+
+// Maps a member type to its JSON_FIELD_ code at compile time.  Members of
+// any other type don't compile.
+template <typename T> struct JSONFieldType;
+template <> struct JSONFieldType<double> { enum { type = JSON_FIELD_DOUBLE }; };
+template <> struct JSONFieldType<float> { enum { type = JSON_FIELD_FLOAT }; };
+template <> struct JSONFieldType<int> { enum { type = JSON_FIELD_INT }; };
+template <> struct JSONFieldType<long> { enum { type = JSON_FIELD_LONG }; };
+template <> struct JSONFieldType<unsigned long> { enum { type = JSON_FIELD_ULONG }; };
+template <> struct JSONFieldType<bool> { enum { type = JSON_FIELD_BOOL }; };
+template <size_t N> struct JSONFieldType<char[N]> { enum { type = JSON_FIELD_STRING }; };
+
+struct JSONField {
+  const char* path;   // e.g. "main.temp", see JSONPathScanner
+  uint8_t type;       // JSON_FIELD_ code
+  uint16_t offset;    // of the member in its struct
+  uint16_t size;      // of the member
+  bool required;
+};
+
+// Schema entries binding a struct member to a JSON path
+#define JSON_MEMBER(Struct, member, path, required)                           \
+  { path, JSONFieldType<decltype(((Struct*)0)->member)>::type,                \
+    offsetof(Struct, member), sizeof(((Struct*)0)->member), required }
+#define JSON_FIELD(Struct, member, path) JSON_MEMBER(Struct, member, path, true)
+#define JSON_OPTIONAL_FIELD(Struct, member, path) JSON_MEMBER(Struct, member, path, false)
+
+// Fills a struct from a document in one pass, without building a tree.
+// Other fields are skipped as they stream past, and the scan stops once
+// every field of the schema has been seen.
+//
+//   struct WeatherNow { double temp; int humidity; };
+//   const JSONField weatherSchema[] = {
+//     JSON_FIELD(WeatherNow, temp, "main.temp"),
+//     JSON_FIELD(WeatherNow, humidity, "main.humidity"),
+//   };
+//   JSONDecoder<WeatherNow> decoder(weatherSchema, 2);
+//
+//   WeatherNow now;
+//   decoder.begin(now);
+//   http.writeToStream(&decoder);   // or decoder.print(text)
+//   if (decoder.end() == JSON_DECODE_OK) ...
+//
+// On an error, errorField() is the index of the schema entry at fault (-1
+// for a syntax error).  Members of optional fields that are missing are
+// left as they were.
+class JSONDecoderBase : public JSONPathScanner {
+public:
+  JSONDecoderBase(const JSONField* fields, uint8_t count);
+
+  uint8_t end();
+
+  uint8_t error() const { return _error; }
+  int8_t errorField() const { return _errorField; }
+  const char* errorPath() const;
+
+protected:
+  void start(void* target);
+  virtual void value(const char* path, const char* text, uint8_t type);
+
+private:
+  uint8_t store(const JSONField& field, const char* text, uint8_t type);
+
+  const JSONField* _fields;
+  uint8_t _count;
+  void* _target;
+  uint16_t _found;    // bit i set once fields[i] has been stored
+  uint8_t _error;
+  int8_t _errorField;
+};
+
+template <typename T>
+class JSONDecoder : public JSONDecoderBase {
+public:
+  JSONDecoder(const JSONField* fields, uint8_t count) :
+    JSONDecoderBase(fields, count)
+  {
+  }
+
+  void begin(T& target) { start(&target); }
+
+  uint8_t decode(T& target, const char* json)
+  {
+    begin(target);
+    print(json);
+    return end();
+  }
+};
+
+#endif
@@ -0,0 +1,184 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "cjson/cJSON.h"
+
+#include "JSONIndex.h"
+
+struct JSONIndexTable {
+  cJSON* object;
+  cJSON** slots;
+  uint16_t mask;            // slot count - 1, a power of two less one
+};
+
+static JSONIndexTable tables[JSON_INDEX_CACHE];
+static uint8_t nextTable = 0;
+
+// the last object scanned without an index
+static cJSON* candidate = NULL;
+
+static char foldCase(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// FNV-1a over the lower-cased key
+static uint32_t hashKey(const char* key)
+{
+  uint32_t hash = 2166136261UL;
+
+  for (; *key; key++) {
+    hash ^= (uint8_t)foldCase(*key);
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
+
+static bool sameKey(const char* a, const char* b, bool caseSensitive)
+{
+  if (caseSensitive) {
+    return strcmp(a, b) == 0;
+  }
+
+  for (; *a && foldCase(*a) == foldCase(*b); a++, b++) {
+  }
+
+  return foldCase(*a) == foldCase(*b);
+}
+
+// cJSON's own search order: the first matching child wins
+static cJSON* scan(cJSON* object, const char* key, bool caseSensitive)
+{
+  for (cJSON* child = object->child; child != NULL; child = child->next) {
+    if (child->string != NULL && sameKey(child->string, key, caseSensitive)) {
+      return child;
+    }
+  }
+
+  return NULL;
+}
+
+static JSONIndexTable* findTable(cJSON* object)
+{
+  for (uint8_t i = 0; i < JSON_INDEX_CACHE; i++) {
+    if (tables[i].object == object) {
+      return &tables[i];
+    }
+  }
+
+  return NULL;
+}
+
+static JSONIndexTable* buildTable(cJSON* object)
+{
+  uint16_t count = 0;
+
+  for (cJSON* child = object->child; child != NULL; child = child->next) {
+    if (count == 0x4000) {
+      return NULL;
+    }
+    count++;
+  }
+
+  if (count < JSON_INDEX_MIN_KEYS) {
+    return NULL;
+  }
+
+  // at most half full, so probes stay short
+  uint16_t size = 16;
+
+  while (size < count * 2) {
+    size <<= 1;
+  }
+
+  cJSON** slots = (cJSON**)calloc(size, sizeof(cJSON*));
+
+  if (slots == NULL) {
+    return NULL;
+  }
+
+  JSONIndexTable* table = &tables[nextTable];
+
+  nextTable = (nextTable + 1) % JSON_INDEX_CACHE;
+
+  free(table->slots);
+  table->object = object;
+  table->slots = slots;
+  table->mask = size - 1;
+
+  // children go in in order, so an earlier duplicate sits earlier on the
+  // probe sequence and is found first, as in a scan
+  for (cJSON* child = object->child; child != NULL; child = child->next) {
+    if (child->string == NULL) {
+      continue;
+    }
+
+    uint16_t i = hashKey(child->string) & table->mask;
+
+    while (slots[i] != NULL) {
+      i = (i + 1) & table->mask;
+    }
+    slots[i] = child;
+  }
+
+  return table;
+}
+
+cJSON* JSONIndex::find(cJSON* object, const char* key, bool caseSensitive)
+{
+  if (object == NULL || key == NULL) {
+    return NULL;
+  }
+
+  JSONIndexTable* table = findTable(object);
+
+  if (table == NULL) {
+    if (object != candidate) {
+      candidate = object;
+
+      return scan(object, key, caseSensitive);
+    }
+
+    table = buildTable(object);
+
+    if (table == NULL) {
+      return scan(object, key, caseSensitive);
+    }
+  }
+
+  for (uint16_t i = hashKey(key) & table->mask; table->slots[i] != NULL; i = (i + 1) & table->mask) {
+    if (sameKey(table->slots[i]->string, key, caseSensitive)) {
+      return table->slots[i];
+    }
+  }
+
+  return NULL;
+}
+
+void JSONIndex::invalidate()
+{
+  for (uint8_t i = 0; i < JSON_INDEX_CACHE; i++) {
+    free(tables[i].slots);
+    tables[i].slots = NULL;
+    tables[i].object = NULL;
+  }
+
+  candidate = NULL;
+}
@@ -0,0 +1,49 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_INDEX_H_
+#define _JSON_INDEX_H_
+
+#include <Arduino.h>
+
+struct cJSON;
+
+#define JSON_INDEX_MIN_KEYS 8  // smaller objects are always scanned
+#define JSON_INDEX_CACHE 2     // objects indexed at the same time
+
+// Hash index over the members of large objects, used by every key lookup
+// in JSONVar and JSONRef.
+//
+// cJSON finds a member by walking the object's children, so looking up
+// every key of an n-key object costs n^2 / 2 string compares.  The index is
+// an open-addressing table of child pointers, hashed on the case-folded key
+// so the same table serves case-sensitive and case-insensitive lookups.
+// It is built lazily, on the second lookup in the same object, so one-off
+// lookups (such as filter() probing each array element) never pay for it.
+//
+// Any change to a tree through JSONVar drops every table; code that edits
+// cJSON nodes directly must call invalidate() itself.
+class JSONIndex {
+public:
+  static struct cJSON* find(struct cJSON* object, const char* key, bool caseSensitive = true);
+
+  static void invalidate();
+};
+
+#endif
@@ -0,0 +1,309 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+// In-situ parser: builds a normal cJSON tree, but keys and string values
+// are unescaped and null-terminated inside the caller's buffer and the
+// nodes point at them (cJSON_StringIsConst / cJSON_IsReference), so only
+// the nodes themselves are allocated.  Every escape sequence is at least as
+// long as the bytes it decodes to, which is what makes writing the result
+// back into the same buffer safe.
+//
+// Strings end at their first null byte, so a \u0000 escape would cut its
+// string short in place; it is rejected, as are unpaired surrogates.
+
+#include <DecimalCodec.h>
+
+#include "cjson/cJSON.h"
+
+#include "JSONVar.h"
+
+#define JSON_IN_PLACE_DEPTH 32   // deepest nesting accepted
+
+static cJSON* parseValue(char*& p, uint8_t depth);
+
+static void skipSpace(char*& p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+    p++;
+  }
+}
+
+static int hexDigit(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+
+  return -1;
+}
+
+static bool parseHex4(const char* p, unsigned long& code)
+{
+  code = 0;
+
+  for (int i = 0; i < 4; i++) {
+    int digit = hexDigit(p[i]);
+
+    if (digit < 0) {
+      return false;
+    }
+    code = (code << 4) | digit;
+  }
+
+  return true;
+}
+
+// p is on the opening quote; on return it is just past the closing one
+static char* parseString(char*& p)
+{
+  char* start = ++p;
+  char* out = start;
+
+  while (*p != '"') {
+    if (*p == '\0') {
+      return NULL;
+    }
+
+    if (*p != '\\') {
+      *out++ = *p++;
+      continue;
+    }
+
+    p++;
+    switch (*p) {
+      case '"':
+      case '\\':
+      case '/': *out++ = *p++; break;
+      case 'b': *out++ = '\b'; p++; break;
+      case 'f': *out++ = '\f'; p++; break;
+      case 'n': *out++ = '\n'; p++; break;
+      case 'r': *out++ = '\r'; p++; break;
+      case 't': *out++ = '\t'; p++; break;
+
+      case 'u': {
+        unsigned long code;
+
+        if (!parseHex4(p + 1, code) || code == 0) {
+          return NULL;
+        }
+        p += 5;
+
+        // a low surrogate can only follow a high one
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+          return NULL;
+        }
+
+        // a high surrogate needs its low half to make one code point
+        if (code >= 0xD800 && code <= 0xDBFF) {
+          unsigned long low;
+
+          if (p[0] != '\\' || p[1] != 'u' || !parseHex4(p + 2, low) ||
+              low < 0xDC00 || low > 0xDFFF) {
+            return NULL;
+          }
+          p += 6;
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        // encode as UTF-8
+        if (code < 0x80) {
+          *out++ = code;
+        } else if (code < 0x800) {
+          *out++ = 0xC0 | (code >> 6);
+          *out++ = 0x80 | (code & 0x3F);
+        } else if (code < 0x10000) {
+          *out++ = 0xE0 | (code >> 12);
+          *out++ = 0x80 | ((code >> 6) & 0x3F);
+          *out++ = 0x80 | (code & 0x3F);
+        } else {
+          *out++ = 0xF0 | (code >> 18);
+          *out++ = 0x80 | ((code >> 12) & 0x3F);
+          *out++ = 0x80 | ((code >> 6) & 0x3F);
+          *out++ = 0x80 | (code & 0x3F);
+        }
+        break;
+      }
+
+      default:
+        return NULL;
+    }
+  }
+
+  // out never passes the closing quote, so no unread byte is overwritten
+  *out = '\0';
+  p++;
+
+  return start;
+}
+
+static bool matchLiteral(char*& p, const char* literal)
+{
+  size_t length = strlen(literal);
+
+  if (strncmp(p, literal, length) != 0) {
+    return false;
+  }
+  p += length;
+
+  return true;
+}
+
+static cJSON* parseObject(char*& p, uint8_t depth)
+{
+  cJSON* object = cJSON_CreateObject();
+
+  p++;
+  skipSpace(p);
+  if (*p == '}') {
+    p++;
+    return object;
+  }
+
+  while (object) {
+    if (*p != '"') {
+      break;
+    }
+
+    char* key = parseString(p);
+    if (key == NULL) {
+      break;
+    }
+
+    skipSpace(p);
+    if (*p != ':') {
+      break;
+    }
+    p++;
+
+    cJSON* item = parseValue(p, depth);
+    if (item == NULL) {
+      break;
+    }
+    cJSON_AddItemToObjectCS(object, key, item);
+
+    skipSpace(p);
+    if (*p == '}') {
+      p++;
+      return object;
+    }
+    if (*p != ',') {
+      break;
+    }
+    p++;
+    skipSpace(p);
+  }
+
+  cJSON_Delete(object);
+  return NULL;
+}
+
+static cJSON* parseArray(char*& p, uint8_t depth)
+{
+  cJSON* array = cJSON_CreateArray();
+
+  p++;
+  skipSpace(p);
+  if (*p == ']') {
+    p++;
+    return array;
+  }
+
+  while (array) {
+    cJSON* item = parseValue(p, depth);
+    if (item == NULL) {
+      break;
+    }
+    cJSON_AddItemToArray(array, item);
+
+    skipSpace(p);
+    if (*p == ']') {
+      p++;
+      return array;
+    }
+    if (*p != ',') {
+      break;
+    }
+    p++;
+  }
+
+  cJSON_Delete(array);
+  return NULL;
+}
+
+static cJSON* parseValue(char*& p, uint8_t depth)
+{
+  skipSpace(p);
+
+  switch (*p) {
+    case '{':
+    case '[':
+      if (depth == JSON_IN_PLACE_DEPTH) {
+        return NULL;
+      }
+      return (*p == '{') ? parseObject(p, depth + 1) : parseArray(p, depth + 1);
+
+    case '"': {
+      char* s = parseString(p);
+
+      return s ? cJSON_CreateStringReference(s) : NULL;
+    }
+
+    case 't':
+      return matchLiteral(p, "true") ? cJSON_CreateTrue() : NULL;
+
+    case 'f':
+      return matchLiteral(p, "false") ? cJSON_CreateFalse() : NULL;
+
+    case 'n':
+      return matchLiteral(p, "null") ? cJSON_CreateNull() : NULL;
+  }
+
+  const char* end;
+  double number = decimalParse(p, &end, true);
+
+  if (end == p) {
+    return NULL;
+  }
+  p = (char*)end;
+  return cJSON_CreateNumber(number);
+}
+
+JSONVar JSONVar::parseInPlace(char* s)
+{
+  if (s == NULL) {
+    return JSONVar(NULL, NULL);
+  }
+
+  cJSON* json = parseValue(s, 0);
+
+  // nothing but whitespace may follow the document
+  if (json != NULL) {
+    skipSpace(s);
+    if (*s != '\0') {
+      cJSON_Delete(json);
+      json = NULL;
+    }
+  }
+
+  return JSONVar(json, NULL);
+}
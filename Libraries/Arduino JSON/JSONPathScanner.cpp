@@ -0,0 +1,220 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <DecimalCodec.h>
+
+#include "JSONPathScanner.h"
+
+JSONPathScanner::JSONPathScanner()
+{
+  reset();
+}
+
+void JSONPathScanner::reset()
+{
+  JSONSaxParser::reset();
+
+  _depth = 0;
+  _path[0] = '\0';
+  _pathLen = 0;
+  _lostDepth = 0;
+}
+
+void JSONPathScanner::onStartObject()
+{
+  beginValue();
+  push(false);
+}
+
+void JSONPathScanner::onEndObject()
+{
+  pop();
+}
+
+void JSONPathScanner::onStartArray()
+{
+  beginValue();
+  push(true);
+}
+
+void JSONPathScanner::onEndArray()
+{
+  pop();
+}
+
+void JSONPathScanner::onKey(const char* key)
+{
+  _pathLen = _levels[_depth - 1].base;
+  _path[_pathLen] = '\0';
+  if (_lostDepth == _depth) {
+    _lostDepth = 0;
+  }
+
+  if (_pathLen > 0) {
+    appendPath(".");
+  }
+  appendPath(key);
+
+  if (truncated() && !_lostDepth) {
+    _lostDepth = _depth;
+  }
+}
+
+void JSONPathScanner::onString(const char* value)
+{
+  beginValue();
+  emit(value, JSON_SCAN_STRING);
+}
+
+void JSONPathScanner::onNumber(const char* text)
+{
+  beginValue();
+  emit(text, JSON_SCAN_NUMBER);
+}
+
+void JSONPathScanner::onBool(bool value)
+{
+  beginValue();
+  emit(value ? "true" : "false", JSON_SCAN_LITERAL);
+}
+
+void JSONPathScanner::onNull()
+{
+  beginValue();
+  emit("null", JSON_SCAN_LITERAL);
+}
+
+// array elements get their path from their position
+void JSONPathScanner::beginValue()
+{
+  if (_depth > 0 && _levels[_depth - 1].array) {
+    setIndex(_levels[_depth - 1].index++);
+  }
+}
+
+void JSONPathScanner::push(bool array)
+{
+  if (_depth == JSON_SCAN_DEPTH) {
+    fail();
+    return;
+  }
+
+  Level& level = _levels[_depth++];
+  level.base = _pathLen;
+  level.index = 0;
+  level.array = array;
+}
+
+void JSONPathScanner::pop()
+{
+  if (_lostDepth >= _depth) {
+    _lostDepth = 0;
+  }
+  _pathLen = _levels[--_depth].base;
+  _path[_pathLen] = '\0';
+}
+
+void JSONPathScanner::emit(const char* text, uint8_t type)
+{
+  if (!_lostDepth && !truncated()) {
+    value(_path, text, type);
+  }
+}
+
+void JSONPathScanner::appendPath(const char* s)
+{
+  if (_lostDepth) {
+    return;
+  }
+
+  while (*s) {
+    if (_pathLen == JSON_PATH_MAX) {
+      _lostDepth = _depth;
+      return;
+    }
+    _path[_pathLen++] = *s++;
+  }
+  _path[_pathLen] = '\0';
+}
+
+void JSONPathScanner::setIndex(uint16_t index)
+{
+  char element[8];
+  uint8_t n = sizeof(element) - 1;
+
+  _pathLen = _levels[_depth - 1].base;
+  _path[_pathLen] = '\0';
+  if (_lostDepth == _depth) {
+    _lostDepth = 0;
+  }
+
+  // "[index]", built from the end
+  element[n] = '\0';
+  element[--n] = ']';
+  do {
+    element[--n] = '0' + index % 10;
+    index /= 10;
+  } while (index);
+  element[--n] = '[';
+
+  appendPath(element + n);
+}
+
+JSONPathExtractor::JSONPathExtractor(const char* const* paths, double* values, uint8_t count) :
+  _paths(paths),
+  _values(values),
+  _count(count > JSON_EXTRACT_MAX ? JSON_EXTRACT_MAX : count),
+  _found(0)
+{
+}
+
+void JSONPathExtractor::reset()
+{
+  JSONPathScanner::reset();
+  _found = 0;
+}
+
+bool JSONPathExtractor::found(uint8_t i) const
+{
+  return i < _count && (_found & (1U << i));
+}
+
+bool JSONPathExtractor::complete() const
+{
+  return _count > 0 && _found == (uint16_t)((1UL << _count) - 1);
+}
+
+void JSONPathExtractor::value(const char* path, const char* text, uint8_t type)
+{
+  if (type != JSON_SCAN_NUMBER) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (!(_found & (1U << i)) && strcmp(path, _paths[i]) == 0) {
+      _values[i] = decimalParse(text);
+      _found |= (1U << i);
+
+      if (complete()) {
+        stop();
+      }
+      return;
+    }
+  }
+}
@@ -0,0 +1,118 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_PATH_SCANNER_H_
+#define _JSON_PATH_SCANNER_H_
+
+#include <Arduino.h>
+
+#include "JSONSaxParser.h"
+
+#define JSON_PATH_MAX 48    // longest path, e.g. "weather[0].description"
+#define JSON_SCAN_DEPTH 8   // deepest nesting of objects and arrays
+
+#define JSON_SCAN_STRING 0
+#define JSON_SCAN_NUMBER 1
+#define JSON_SCAN_LITERAL 2  // true, false or null
+
+// Reports every scalar of a document with its path, on top of
+// JSONSaxParser, without building a tree or holding the document.
+//
+// Being a Print, it can be handed straight to HTTPClient::writeToStream()
+// (which also undoes chunked encoding) or fed from any Stream.  Paths use
+// "." between keys and "[n]" for array elements: {"main":{"temp":280.3}}
+// gives "main.temp", {"weather":[{"id":800}]} gives "weather[0].id".  All
+// state is fixed size; a path or scalar that doesn't fit is skipped rather
+// than reported truncated.
+//
+// A subclass calls stop() once it has what it needs.  Bytes after that,
+// or after the document or an error, are accepted and discarded unparsed
+// so the sender (and a kept-alive connection) stays in sync.
+class JSONPathScanner : public JSONSaxParser {
+public:
+  JSONPathScanner();
+
+  virtual void reset();
+
+  bool scanning() const { return parsing(); }
+
+protected:
+  virtual void value(const char* path, const char* text, uint8_t type) = 0;
+
+  virtual void onStartObject();
+  virtual void onEndObject();
+  virtual void onStartArray();
+  virtual void onEndArray();
+  virtual void onKey(const char* key);
+  virtual void onString(const char* value);
+  virtual void onNumber(const char* text);
+  virtual void onBool(bool value);
+  virtual void onNull();
+
+private:
+  void beginValue();
+  void push(bool array);
+  void pop();
+  void emit(const char* text, uint8_t type);
+  void appendPath(const char* s);
+  void setIndex(uint16_t index);
+
+  struct Level {
+    uint8_t base;     // path length before this container's member
+    uint16_t index;   // next element number, arrays only
+    bool array;
+  };
+
+  Level _levels[JSON_SCAN_DEPTH];
+  uint8_t _depth;
+  char _path[JSON_PATH_MAX + 1];
+  uint8_t _pathLen;
+  uint8_t _lostDepth;  // depth whose member path didn't fit, 0 if none
+};
+
+#define JSON_EXTRACT_MAX 16
+
+// Looks up a fixed list of numeric fields and stops the scan as soon as
+// all of them have been seen, e.g. for an OpenWeatherMap reply:
+//
+//   const char* paths[] = { "main.temp", "main.humidity", "wind.speed" };
+//   double values[3];
+//   JSONPathExtractor fields(paths, values, 3);
+//   http.writeToStream(&fields);
+//   if (fields.complete()) ...
+class JSONPathExtractor : public JSONPathScanner {
+public:
+  JSONPathExtractor(const char* const* paths, double* values, uint8_t count);
+
+  virtual void reset();
+
+  bool found(uint8_t i) const;
+  bool complete() const;
+
+protected:
+  virtual void value(const char* path, const char* text, uint8_t type);
+
+private:
+  const char* const* _paths;
+  double* _values;
+  uint8_t _count;
+  uint16_t _found;  // bit i set once paths[i] has been seen
+};
+
+#endif
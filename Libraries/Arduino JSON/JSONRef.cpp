@@ -0,0 +1,128 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "cjson/cJSON.h"
+
+#include "JSONIndex.h"
+#include "JSONVar.h"
+#include "JSONRef.h"
+
+JSONRef::JSONRef(struct cJSON* json) :
+  _json(json)
+{
+}
+
+JSONRef::JSONRef() :
+  JSONRef((struct cJSON*)NULL)
+{
+}
+
+JSONRef::JSONRef(const JSONVar& v) :
+  JSONRef(v._json)
+{
+}
+
+JSONRef JSONRef::get(const char* key) const
+{
+  if (!cJSON_IsObject(_json)) {
+    return JSONRef();
+  }
+
+  return JSONRef(JSONIndex::find(_json, key));
+}
+
+JSONRef JSONRef::get(const String& key) const
+{
+  return get(key.c_str());
+}
+
+JSONRef JSONRef::get(int index) const
+{
+  if (!cJSON_IsArray(_json)) {
+    return JSONRef();
+  }
+
+  return JSONRef(cJSON_GetArrayItem(_json, index));
+}
+
+bool JSONRef::exists() const
+{
+  return _json != NULL;
+}
+
+bool JSONRef::isNull() const
+{
+  return cJSON_IsNull(_json);
+}
+
+bool JSONRef::isBool() const
+{
+  return cJSON_IsBool(_json);
+}
+
+bool JSONRef::isNumber() const
+{
+  return cJSON_IsNumber(_json);
+}
+
+bool JSONRef::isString() const
+{
+  return cJSON_IsString(_json);
+}
+
+bool JSONRef::isArray() const
+{
+  return cJSON_IsArray(_json);
+}
+
+bool JSONRef::isObject() const
+{
+  return cJSON_IsObject(_json);
+}
+
+bool JSONRef::asBool(bool fallback) const
+{
+  return cJSON_IsBool(_json) ? cJSON_IsTrue(_json) : fallback;
+}
+
+int JSONRef::asInt(int fallback) const
+{
+  return cJSON_IsNumber(_json) ? _json->valueint : fallback;
+}
+
+double JSONRef::asDouble(double fallback) const
+{
+  return cJSON_IsNumber(_json) ? _json->valuedouble : fallback;
+}
+
+const char* JSONRef::asString(const char* fallback) const
+{
+  return cJSON_IsString(_json) ? _json->valuestring : fallback;
+}
+
+int JSONRef::length() const
+{
+  if (cJSON_IsString(_json)) {
+    return strlen(_json->valuestring);
+  } else if (cJSON_IsArray(_json) || cJSON_IsObject(_json)) {
+    return cJSON_GetArraySize(_json);
+  } else {
+    return -1;
+  }
+}
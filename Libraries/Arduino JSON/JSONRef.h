@@ -0,0 +1,72 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_REF_H_
+#define _JSON_REF_H_
+
+#include <Arduino.h>
+
+struct cJSON;
+class JSONVar;
+
+// Read-only view of a value inside a JSONVar, for lookups that shouldn't
+// allocate.
+//
+// Unlike JSONVar::operator[], get() never adds missing members and never
+// copies: a missing key or index gives an empty ref, and every read on an
+// empty ref returns its fallback, so chains need no checks in between:
+//
+//   double tempK = doc.get("main").get("temp").asDouble();
+//
+// A JSONRef is only valid while the JSONVar it came from is alive and
+// unchanged.
+class JSONRef {
+public:
+  JSONRef();
+  JSONRef(const JSONVar& v);
+
+  JSONRef get(const char* key) const;
+  JSONRef get(const String& key) const;
+  JSONRef get(int index) const;
+  JSONRef operator[](const char* key) const { return get(key); }
+  JSONRef operator[](const String& key) const { return get(key); }
+  JSONRef operator[](int index) const { return get(index); }
+
+  bool exists() const;
+  bool isNull() const;
+  bool isBool() const;
+  bool isNumber() const;
+  bool isString() const;
+  bool isArray() const;
+  bool isObject() const;
+
+  bool asBool(bool fallback = false) const;
+  int asInt(int fallback = 0) const;
+  double asDouble(double fallback = NAN) const;
+  const char* asString(const char* fallback = NULL) const;
+
+  int length() const;
+
+private:
+  JSONRef(struct cJSON* json);
+
+  struct cJSON* _json;
+};
+
+#endif
@@ -0,0 +1,417 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <DecimalCodec.h>
+
+#include "JSONSaxParser.h"
+
+// Parser states
+#define SAX_VALUE 0         // expecting a value
+#define SAX_ARRAY_START 1   // expecting a value or ']'
+#define SAX_OBJECT_START 2  // expecting a key or '}'
+#define SAX_KEY 3           // expecting a key
+#define SAX_COLON 4         // after a key
+#define SAX_STRING 5        // inside a key or string
+#define SAX_ESCAPE 6        // after a backslash
+#define SAX_UNICODE 7       // inside the digits of a \u escape
+#define SAX_LITERAL 8       // inside a number, true, false or null
+#define SAX_AFTER 9         // after a value, expecting ',' or the end of its container
+#define SAX_DONE 10         // the document is complete
+#define SAX_STOPPED 11      // stop() was called
+#define SAX_ERROR 12        // malformed, too deeply nested, or fail() was called
+
+static bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool isLiteral(char c)
+{
+  return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+         c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static int hexDigit(char c)
+{
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+
+  return -1;
+}
+
+JSONSaxParser::JSONSaxParser()
+{
+  reset();
+}
+
+JSONSaxParser::~JSONSaxParser()
+{
+}
+
+void JSONSaxParser::reset()
+{
+  _state = SAX_VALUE;
+  _error = JSON_SAX_OK;
+  _depth = 0;
+  _arrays = 0;
+  _key = false;
+  _hexLeft = 0;
+  _code = 0;
+  _highSurrogate = 0;
+  _textLen = 0;
+  _truncated = false;
+}
+
+size_t JSONSaxParser::write(uint8_t c)
+{
+  if (parsing()) {
+    feed((char)c);
+  }
+
+  return 1;
+}
+
+size_t JSONSaxParser::write(const uint8_t* buffer, size_t size)
+{
+  for (size_t i = 0; i < size && parsing(); i++) {
+    feed((char)buffer[i]);
+  }
+
+  return size;
+}
+
+bool JSONSaxParser::parsing() const
+{
+  return _state < SAX_DONE;
+}
+
+bool JSONSaxParser::finished() const
+{
+  return _state == SAX_DONE;
+}
+
+bool JSONSaxParser::failed() const
+{
+  return _state == SAX_ERROR;
+}
+
+void JSONSaxParser::stop()
+{
+  if (parsing()) {
+    _state = SAX_STOPPED;
+  }
+}
+
+void JSONSaxParser::fail()
+{
+  setError(JSON_SAX_REJECTED);
+}
+
+void JSONSaxParser::setError(uint8_t error)
+{
+  if (_state != SAX_ERROR) {
+    _error = error;
+  }
+  _state = SAX_ERROR;
+}
+
+void JSONSaxParser::feed(char c)
+{
+  switch (_state) {
+    case SAX_VALUE:
+      if (!isSpace(c)) {
+        beginValue(c);
+      }
+      return;
+
+    case SAX_ARRAY_START:
+      if (c == ']') {
+        endContainer(c);
+      } else if (!isSpace(c)) {
+        beginValue(c);
+      }
+      return;
+
+    case SAX_OBJECT_START:
+    case SAX_KEY:
+      if (isSpace(c)) {
+        return;
+      }
+      if (c == '}' && _state == SAX_OBJECT_START) {
+        endContainer(c);
+        return;
+      }
+      if (c != '"') {
+        break;
+      }
+      _key = true;
+      _textLen = 0;
+      _truncated = false;
+      _state = SAX_STRING;
+      return;
+
+    case SAX_COLON:
+      if (isSpace(c)) {
+        return;
+      }
+      if (c != ':') {
+        break;
+      }
+      _state = SAX_VALUE;
+      return;
+
+    case SAX_STRING:
+      // the low half of a surrogate pair has to come next
+      if (_highSurrogate && c != '\\') {
+        break;
+      }
+      if (c == '\\') {
+        _state = SAX_ESCAPE;
+      } else if (c == '"') {
+        _text[_textLen] = '\0';
+        if (_key) {
+          _state = SAX_COLON;
+          onKey(_text);
+        } else {
+          endValue();
+          onString(_text);
+        }
+      } else if ((uint8_t)c < 0x20) {
+        break;
+      } else {
+        addText(c);
+      }
+      return;
+
+    case SAX_ESCAPE:
+      if (_highSurrogate && c != 'u') {
+        break;
+      }
+      _state = SAX_STRING;
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/': addText(c); return;
+        case 'b': addText('\b'); return;
+        case 'f': addText('\f'); return;
+        case 'n': addText('\n'); return;
+        case 'r': addText('\r'); return;
+        case 't': addText('\t'); return;
+        case 'u':
+          _code = 0;
+          _hexLeft = 4;
+          _state = SAX_UNICODE;
+          return;
+      }
+      break;
+
+    case SAX_UNICODE: {
+      int digit = hexDigit(c);
+
+      if (digit < 0) {
+        break;
+      }
+      _code = (_code << 4) | digit;
+      if (--_hexLeft == 0) {
+        if (!addCodePoint(_code)) {
+          break;
+        }
+        _state = SAX_STRING;
+      }
+      return;
+    }
+
+    case SAX_LITERAL:
+      if (isLiteral(c)) {
+        addText(c);
+        return;
+      }
+      if (!isSpace(c) && c != ',' && c != '}' && c != ']') {
+        break;
+      }
+      endLiteral();
+      // the delimiter belongs to the enclosing container
+      if (_state == SAX_AFTER) {
+        feed(c);
+      }
+      return;
+
+    case SAX_AFTER:
+      if (isSpace(c)) {
+        return;
+      }
+      if (c == ',') {
+        _state = (_arrays & (1UL << (_depth - 1))) ? SAX_VALUE : SAX_KEY;
+        return;
+      }
+      endContainer(c);
+      return;
+  }
+
+  setError(JSON_SAX_SYNTAX);
+}
+
+void JSONSaxParser::beginValue(char c)
+{
+  _textLen = 0;
+  _truncated = false;
+
+  if (c == '"') {
+    _key = false;
+    _state = SAX_STRING;
+    return;
+  }
+
+  if (isLiteral(c)) {
+    addText(c);
+    _state = SAX_LITERAL;
+    return;
+  }
+
+  if (c != '{' && c != '[') {
+    setError(JSON_SAX_SYNTAX);
+    return;
+  }
+  if (_depth == JSON_SAX_DEPTH) {
+    setError(JSON_SAX_TOO_DEEP);
+    return;
+  }
+
+  if (c == '[') {
+    _arrays |= (1UL << _depth);
+    _state = SAX_ARRAY_START;
+  } else {
+    _arrays &= ~(1UL << _depth);
+    _state = SAX_OBJECT_START;
+  }
+  _depth++;
+
+  if (c == '[') {
+    onStartArray();
+  } else {
+    onStartObject();
+  }
+}
+
+void JSONSaxParser::endContainer(char c)
+{
+  bool array = _depth > 0 && (_arrays & (1UL << (_depth - 1)));
+
+  if (_depth == 0 || c != (array ? ']' : '}')) {
+    setError(JSON_SAX_SYNTAX);
+    return;
+  }
+
+  _depth--;
+  endValue();
+
+  if (array) {
+    onEndArray();
+  } else {
+    onEndObject();
+  }
+}
+
+void JSONSaxParser::endLiteral()
+{
+  _text[_textLen] = '\0';
+
+  if (_text[0] == '-' || (_text[0] >= '0' && _text[0] <= '9')) {
+    const char* end;
+
+    if (_truncated) {
+      setError(JSON_SAX_TOO_LONG);
+      return;
+    }
+    decimalParse(_text, &end, true);
+    if (end == _text || *end != '\0') {
+      setError(JSON_SAX_SYNTAX);
+      return;
+    }
+    endValue();
+    onNumber(_text);
+  } else if (strcmp(_text, "true") == 0 || strcmp(_text, "false") == 0) {
+    endValue();
+    onBool(_text[0] == 't');
+  } else if (strcmp(_text, "null") == 0) {
+    endValue();
+    onNull();
+  } else {
+    setError(JSON_SAX_SYNTAX);
+  }
+}
+
+// called before the event, so a handler's stop() or fail() sticks
+void JSONSaxParser::endValue()
+{
+  _state = (_depth == 0) ? SAX_DONE : SAX_AFTER;
+}
+
+void JSONSaxParser::addText(char c)
+{
+  if (_textLen < JSON_SAX_TEXT_MAX) {
+    _text[_textLen++] = c;
+  } else {
+    _truncated = true;
+  }
+}
+
+// false for a lone surrogate or \u0000
+bool JSONSaxParser::addCodePoint(unsigned long code)
+{
+  bool low = (code >= 0xDC00 && code <= 0xDFFF);
+
+  if (code == 0 || low != (_highSurrogate != 0)) {
+    return false;
+  }
+
+  // a high surrogate waits for its low half to make one code point
+  if (code >= 0xD800 && code <= 0xDBFF) {
+    _highSurrogate = code;
+    return true;
+  }
+  if (low) {
+    code = 0x10000 + ((unsigned long)(_highSurrogate - 0xD800) << 10) + (code - 0xDC00);
+  }
+  _highSurrogate = 0;
+
+  // encode as UTF-8
+  if (code < 0x80) {
+    addText(code);
+  } else if (code < 0x800) {
+    addText(0xC0 | (code >> 6));
+    addText(0x80 | (code & 0x3F));
+  } else if (code < 0x10000) {
+    addText(0xE0 | (code >> 12));
+    addText(0x80 | ((code >> 6) & 0x3F));
+    addText(0x80 | (code & 0x3F));
+  } else {
+    addText(0xF0 | (code >> 18));
+    addText(0x80 | ((code >> 12) & 0x3F));
+    addText(0x80 | ((code >> 6) & 0x3F));
+    addText(0x80 | (code & 0x3F));
+  }
+
+  return true;
+}
@@ -0,0 +1,109 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_SAX_PARSER_H_
+#define _JSON_SAX_PARSER_H_
+
+#include <Arduino.h>
+
+#define JSON_SAX_DEPTH 32     // deepest nesting of objects and arrays
+#define JSON_SAX_TEXT_MAX 32  // longest key, string or number passed whole
+
+// Reasons for failed(), from error()
+#define JSON_SAX_OK 0
+#define JSON_SAX_SYNTAX 1    // malformed JSON, including lone surrogates and \u0000
+#define JSON_SAX_TOO_DEEP 2  // nested deeper than JSON_SAX_DEPTH
+#define JSON_SAX_TOO_LONG 3  // a number longer than JSON_SAX_TEXT_MAX
+#define JSON_SAX_REJECTED 4  // a handler called fail()
+
+// Event-driven JSON parser: reports the document as a sequence of calls
+// to the on...() methods instead of building it in memory.
+//
+// Input is pushed in through the Print interface in chunks of any size, so
+// a token may be split across writes, e.g. print() each buffer read from a
+// WiFiClient, or pass the parser to HTTPClient::writeToStream().  State is
+// a fixed few dozen bytes whatever the size of the document: one bit per
+// nesting level and one text buffer.  Keys and strings longer than
+// JSON_SAX_TEXT_MAX are cut short and flagged by truncated(), so a handler
+// can skip them; a number that long can't be cut without changing its
+// value, so it fails the document with JSON_SAX_TOO_LONG.  Numbers follow
+// JSON's grammar strictly ("-.5", "1." and "01" are errors).  Strings are
+// handed over null-terminated, so a \u0000 escape, which would cut them
+// short, is an error, as is a surrogate escape without its other half.
+//
+// Override the events of interest; the rest do nothing.  A handler may
+// call stop() when it has what it needs, or fail() to reject the
+// document.  Bytes after that, or after the document, are accepted and
+// discarded unparsed so the sender stays in sync.
+class JSONSaxParser : public Print {
+public:
+  JSONSaxParser();
+  virtual ~JSONSaxParser();
+
+  virtual void reset();
+
+  virtual size_t write(uint8_t c);
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  using Print::write;
+
+  bool parsing() const;    // the document isn't complete yet
+  bool finished() const;   // the whole document was parsed
+  bool failed() const;
+  uint8_t error() const { return _error; }
+  uint8_t depth() const { return _depth; }
+
+protected:
+  virtual void onStartObject() {}
+  virtual void onEndObject() {}
+  virtual void onStartArray() {}
+  virtual void onEndArray() {}
+  virtual void onKey(const char* key) { (void)key; }
+  virtual void onString(const char* value) { (void)value; }
+  virtual void onNumber(const char* text) { (void)text; }   // see decimalParse()
+  virtual void onBool(bool value) { (void)value; }
+  virtual void onNull() {}
+
+  void stop();
+  void fail();
+  bool truncated() const { return _truncated; }
+
+private:
+  void feed(char c);
+  void beginValue(char c);
+  void endContainer(char c);
+  void endLiteral();
+  void endValue();
+  void addText(char c);
+  bool addCodePoint(unsigned long code);
+  void setError(uint8_t error);
+
+  uint8_t _state;
+  uint8_t _error;
+  uint8_t _depth;
+  uint32_t _arrays;        // bit n set if nesting level n is an array
+  bool _key;               // the string being read is a key
+  uint8_t _hexLeft;        // \u digits still to come
+  uint16_t _code;          // \u digits read so far
+  uint16_t _highSurrogate; // first half of a \u pair, 0 if none
+  char _text[JSON_SAX_TEXT_MAX + 1];
+  uint8_t _textLen;
+  bool _truncated;
+};
+
+#endif
@@ -19,7 +19,47 @@
 
 #include "cjson/cJSON.h"
 
+#include "JSONIndex.h"
 #include "JSONVar.h"
+#include "JSONWriter.h"
+
+// Give json and its descendants keys of their own.  cJSON_Duplicate()
+// shares keys flagged cJSON_StringIsConst instead of copying them, and
+// those of a parseInPlace() document point into the caller's buffer.
+static bool copyConstKeys(cJSON* json)
+{
+  for (cJSON* child = json->child; child != NULL; child = child->next) {
+    if ((child->type & cJSON_StringIsConst) && child->string != NULL) {
+      size_t length = strlen(child->string) + 1;
+      char* key = (char*)cJSON_malloc(length);
+
+      if (key == NULL) {
+        return false;
+      }
+      memcpy(key, child->string, length);
+      child->string = key;
+      child->type &= ~cJSON_StringIsConst;
+    }
+    if (!copyConstKeys(child)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// A deep copy that doesn't depend on anything json points into.
+static cJSON* duplicate(const cJSON* json)
+{
+  cJSON* copy = cJSON_Duplicate(json, true);
+
+  if (copy != NULL && !copyConstKeys(copy)) {
+    cJSON_Delete(copy);
+    return NULL;
+  }
+
+  return copy;
+}
 
 JSONVar::JSONVar(struct cJSON* json, struct cJSON* parent) :
   _json(json),
@@ -101,24 +141,18 @@ JSONVar::JSONVar(const String& s)  :
 
 JSONVar::JSONVar(const JSONVar& v)
 {
-  _json = cJSON_Duplicate(v._json, true);
+  _json = duplicate(v._json);
   _parent = NULL;
 }
 
 #if __cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__)
-JSONVar::JSONVar(JSONVar&& v)
+JSONVar::JSONVar(JSONVar&& v) :
+  _json(v._json),
+  _parent(v._parent)
 {
-  cJSON* tmp;
-
-  // swap _json
-  tmp = _json;
-  _json = v._json;
-  v._json = tmp;
-
-  // swap parent
-  tmp = _parent;
-  _parent = v._parent;
-  v._parent = tmp;
+  // take over v's tree; v is left undefined so its destructor frees nothing
+  v._json = NULL;
+  v._parent = NULL;
 }
 #endif
 
@@ -136,25 +170,55 @@ JSONVar::JSONVar() :
 JSONVar::~JSONVar()
 {
   if (_json != NULL && _parent == NULL) {
+    JSONIndex::invalidate();
     cJSON_Delete(_json);
 
     _json = NULL;
   }
 }
 
+// Same output as cJSON_PrintUnformatted() (apart from the number notes in
+// JSONWriter.h), but written to the Print as the tree is walked instead of
+// into a heap buffer first
+static void writeJson(JSONWriter& writer, const cJSON* json)
+{
+  if (cJSON_IsBool(json)) {
+    writer.value((bool)cJSON_IsTrue(json));
+  } else if (cJSON_IsNumber(json)) {
+    writer.value(json->valuedouble);
+  } else if (cJSON_IsString(json)) {
+    writer.value(json->valuestring);
+  } else if (cJSON_IsRaw(json)) {
+    writer.valueRaw(json->valuestring);
+  } else if (cJSON_IsArray(json)) {
+    writer.beginArray();
+    for (const cJSON* child = json->child; child != NULL; child = child->next) {
+      writeJson(writer, child);
+    }
+    writer.endArray();
+  } else if (cJSON_IsObject(json)) {
+    writer.beginObject();
+    for (const cJSON* child = json->child; child != NULL; child = child->next) {
+      writer.key(child->string);
+      writeJson(writer, child);
+    }
+    writer.endObject();
+  } else {
+    writer.valueNull();
+  }
+}
+
 size_t JSONVar::printTo(Print& p) const
 {
   if (_json == NULL) {
     return 0;
   }
 
-  char* s = cJSON_PrintUnformatted(_json);
-
-  size_t writen = p.print(s);
+  JSONWriter writer(p);
 
-  cJSON_free(s);
+  writeJson(writer, _json);
 
-  return writen;
+  return writer.written();
 }
 
 JSONVar::operator bool() const
@@ -229,6 +293,7 @@ void JSONVar::operator=(const JSONVar& v)
 {
   if (&v == &undefined) {
     if (cJSON_IsObject(_parent)) {
+      JSONIndex::invalidate();
       cJSON_DeleteItemFromObjectCaseSensitive(_parent, _json->string);
 
       _json = NULL;
@@ -237,7 +302,7 @@ void JSONVar::operator=(const JSONVar& v)
       replaceJson(cJSON_CreateNull());
     }
   } else {
-    replaceJson(cJSON_Duplicate(v._json, true));
+    replaceJson(duplicate(v._json));
   }
 }
 
@@ -246,6 +311,15 @@ JSONVar& JSONVar::operator=(JSONVar&& v)
 {
   cJSON* tmp;
 
+  // assigning a temporary into a tree, e.g. obj["a"] = JSON.parse(s):
+  // hand its value over to the tree instead of copying it
+  if (_parent != NULL && v._parent == NULL && v._json != NULL) {
+    replaceJson(v._json);
+    v._json = NULL;
+
+    return *this;
+  }
+
   // swap _json
   tmp = _json;
   _json = v._json;
@@ -342,9 +416,10 @@ JSONVar JSONVar::operator[](const char* key)
     replaceJson(cJSON_CreateObject());
   }
 
-  cJSON* json = cJSON_GetObjectItemCaseSensitive(_json, key);
+  cJSON* json = JSONIndex::find(_json, key);
 
   if (json == NULL) {
+    JSONIndex::invalidate();
     json = cJSON_AddNullToObject(_json, key);
   }
   
@@ -392,6 +467,21 @@ JSONVar JSONVar::operator[](const JSONVar& key)
   return JSONVar(NULL, NULL);
 }
 
+JSONRef JSONVar::get(const char* key) const
+{
+  return JSONRef(*this).get(key);
+}
+
+JSONRef JSONVar::get(const String& key) const
+{
+  return get(key.c_str());
+}
+
+JSONRef JSONVar::get(int index) const
+{
+  return JSONRef(*this).get(index);
+}
+
 int JSONVar::length() const
 {
   if (cJSON_IsString(_json)) {
@@ -427,7 +517,7 @@ bool JSONVar::hasOwnProperty(const char* key) const
     return false;
   }
 
-  cJSON* json = cJSON_GetObjectItemCaseSensitive(_json, key);
+  cJSON* json = JSONIndex::find(_json, key);
   return (json != NULL);
 }
 
@@ -491,6 +581,7 @@ void JSONVar::replaceJson(struct cJSON* json)
   cJSON* old = _json;
 
   _json = json;
+  JSONIndex::invalidate();
 
   if (old) {
     if (_parent) {
@@ -512,7 +603,7 @@ bool JSONVar::hasPropertyEqual(const char* key,  const char* value) const {
     return false;
   }
 
-  cJSON* json = cJSON_GetObjectItemCaseSensitive(_json, key);
+  cJSON* json = JSONIndex::find(_json, key);
   return json != NULL && strcmp(value, json->valuestring) == 0;
 } 
 
@@ -542,7 +633,7 @@ JSONVar JSONVar::filter(const char* key, const char* value) const {
   cJSON* json = cJSON_CreateArray();
 
   if(cJSON_IsObject(_json)){
-    test = cJSON_GetObjectItem(_json, key);
+    test = JSONIndex::find(_json, key, false);
     
     if(test != NULL && strcmp(value, test->valuestring) == 0){
       return (*this);
@@ -556,10 +647,10 @@ JSONVar JSONVar::filter(const char* key, const char* value) const {
       continue;
     }
     
-    test = cJSON_GetObjectItem(item, key);
+    test = cJSON_IsObject(item) ? JSONIndex::find(item, key, false) : NULL;
     
     if(test != NULL && strcmp(value, test->valuestring) == 0){
-      cJSON_AddItemToArray(json, cJSON_Duplicate(item,true));
+      cJSON_AddItemToArray(json, duplicate(item));
     }
   }
 
@@ -22,6 +22,8 @@
 
 #include <Arduino.h>
 
+#include "JSONRef.h"
+
 struct cJSON;
 
 #define typeof typeof_
@@ -90,6 +92,10 @@ public:
   JSONVar operator[](int index);
   JSONVar operator[](const JSONVar& key);  
 
+  JSONRef get(const char* key) const;
+  JSONRef get(const String& key) const;
+  JSONRef get(int index) const;
+
   int length() const;
   JSONVar keys() const;
   bool hasOwnProperty(const char* key) const;
@@ -107,10 +113,13 @@ public:
 
   static JSONVar parse(const char* s);
   static JSONVar parse(const String& s);
+  static JSONVar parseInPlace(char* s);
   static String stringify(const JSONVar& value);
   static String typeof_(const JSONVar& value);
 
 private:
+  friend class JSONRef;
+
   JSONVar(struct cJSON* json, struct cJSON* parent);
 
   void replaceJson(struct cJSON* json);
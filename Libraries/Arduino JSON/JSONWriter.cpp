@@ -0,0 +1,332 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <DecimalCodec.h>
+
+#include "JSONWriter.h"
+
+JSONWriter::JSONWriter(Print& out) :
+  _out(out),
+  _written(0),
+  _depth(0),
+  _hasItems(0),
+  _afterKey(false)
+{
+}
+
+JSONWriter& JSONWriter::beginObject()
+{
+  open('{');
+  return *this;
+}
+
+JSONWriter& JSONWriter::endObject()
+{
+  close('}');
+  return *this;
+}
+
+JSONWriter& JSONWriter::beginArray()
+{
+  open('[');
+  return *this;
+}
+
+JSONWriter& JSONWriter::endArray()
+{
+  close(']');
+  return *this;
+}
+
+JSONWriter& JSONWriter::key(const char* name)
+{
+  separate();
+  writeString(name);
+  _written += _out.write(':');
+  _afterKey = true;
+
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(bool b)
+{
+  separate();
+  _written += _out.print(b ? "true" : "false");
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(int i)
+{
+  return value((long)i);
+}
+
+JSONWriter& JSONWriter::value(unsigned int i)
+{
+  return value((unsigned long)i);
+}
+
+JSONWriter& JSONWriter::value(long l)
+{
+  separate();
+  _written += _out.print(l);
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(unsigned long ul)
+{
+  separate();
+  _written += _out.print(ul);
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(double d)
+{
+  if (isnan(d) || isinf(d)) {
+    return valueNull();
+  }
+
+  // whole numbers as integers, like cJSON; the range check comes first, as
+  // converting a larger double to long is undefined
+  if (fabs(d) < 1.0e9 && d == (double)(long)d) {
+    return value((long)d);
+  }
+
+  char buffer[26];
+
+#ifdef __AVR__
+  // double is a 32-bit float here, good for 7 significant digits
+  double magnitude = fabs(d);
+
+  if (magnitude >= 1.0e-3 && magnitude < 1.0e7) {
+    int8_t decimals = 6;
+    double scale = 1.0;
+
+    while (magnitude >= scale * 10.0) {
+      decimals--;
+      scale *= 10.0;
+    }
+    while (magnitude < scale) {
+      decimals++;
+      scale /= 10.0;
+    }
+
+    size_t length = decimalFormat(buffer, d, decimals);
+
+    // "2.500000" -> "2.5"
+    if (decimals > 0) {
+      while (buffer[length - 1] == '0') {
+        length--;
+      }
+      if (buffer[length - 1] == '.') {
+        length--;
+      }
+      buffer[length] = '\0';
+    }
+  } else {
+    dtostre(d, buffer, 6, 0);
+  }
+#else
+  // the shortest of 15 or 17 significant digits that reads back exactly
+  snprintf(buffer, sizeof(buffer), "%1.15g", d);
+  if (strtod(buffer, NULL) != d) {
+    snprintf(buffer, sizeof(buffer), "%1.17g", d);
+  }
+#endif
+
+  separate();
+  _written += _out.print(buffer);
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(double d, uint8_t decimals)
+{
+  if (isnan(d) || isinf(d)) {
+    return valueNull();
+  }
+
+  separate();
+  _written += decimalPrint(_out, d, decimals);
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(const char* s)
+{
+  if (s == NULL) {
+    return valueNull();
+  }
+
+  separate();
+  writeString(s);
+  return *this;
+}
+
+JSONWriter& JSONWriter::value(const String& s)
+{
+  return value(s.c_str());
+}
+
+JSONWriter& JSONWriter::valueNull()
+{
+  separate();
+  _written += _out.print("null");
+  return *this;
+}
+
+JSONWriter& JSONWriter::valueRaw(const char* json)
+{
+  if (json == NULL) {
+    return valueNull();
+  }
+
+  separate();
+  _written += _out.print(json);
+  return *this;
+}
+
+// comma before every element but the first of its container
+void JSONWriter::separate()
+{
+  if (_afterKey) {
+    _afterKey = false;
+    return;
+  }
+
+  if (_depth == 0 || _depth > JSON_WRITER_DEPTH) {
+    return;
+  }
+
+  uint32_t bit = 1UL << (_depth - 1);
+
+  if (_hasItems & bit) {
+    _written += _out.write(',');
+  }
+  _hasItems |= bit;
+}
+
+void JSONWriter::open(char c)
+{
+  separate();
+  _written += _out.write(c);
+
+  if (_depth < JSON_WRITER_DEPTH) {
+    _hasItems &= ~(1UL << _depth);
+  }
+  _depth++;
+}
+
+void JSONWriter::close(char c)
+{
+  if (_depth > 0) {
+    _depth--;
+  }
+  _afterKey = false;
+  _written += _out.write(c);
+}
+
+void JSONWriter::writeString(const char* s)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  _written += _out.write('"');
+
+  // copy runs of plain characters in one write
+  const char* run = s;
+
+  for (; *s; s++) {
+    uint8_t c = *s;
+
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    _written += _out.write((const uint8_t*)run, s - run);
+    run = s + 1;
+
+    char escape[7] = { '\\', 0 };
+    size_t length = 2;
+
+    switch (c) {
+      case '"': escape[1] = '"'; break;
+      case '\\': escape[1] = '\\'; break;
+      case '\b': escape[1] = 'b'; break;
+      case '\f': escape[1] = 'f'; break;
+      case '\n': escape[1] = 'n'; break;
+      case '\r': escape[1] = 'r'; break;
+      case '\t': escape[1] = 't'; break;
+      default:
+        escape[1] = 'u';
+        escape[2] = '0';
+        escape[3] = '0';
+        escape[4] = hex[c >> 4];
+        escape[5] = hex[c & 0x0F];
+        length = 6;
+        break;
+    }
+    _written += _out.write((const uint8_t*)escape, length);
+  }
+
+  _written += _out.write((const uint8_t*)run, s - run);
+  _written += _out.write('"');
+}
+
+JSONBuffer::JSONBuffer(char* buffer, size_t size) :
+  _buffer(buffer),
+  _size(size)
+{
+  clear();
+}
+
+size_t JSONBuffer::write(uint8_t c)
+{
+  if (_size == 0 || _length + 1 >= _size) {
+    _overflowed = true;
+    return 0;
+  }
+
+  _buffer[_length++] = c;
+  _buffer[_length] = '\0';
+  return 1;
+}
+
+size_t JSONBuffer::write(const uint8_t* buffer, size_t size)
+{
+  size_t room = (_size > 0) ? _size - 1 - _length : 0;
+
+  if (size > room) {
+    size = room;
+    _overflowed = true;
+  }
+
+  memcpy(_buffer + _length, buffer, size);
+  _length += size;
+  if (_size > 0) {
+    _buffer[_length] = '\0';
+  }
+  return size;
+}
+
+void JSONBuffer::clear()
+{
+  _length = 0;
+  _overflowed = false;
+
+  if (_size > 0) {
+    _buffer[0] = '\0';
+  }
+}
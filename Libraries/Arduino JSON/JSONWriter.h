@@ -0,0 +1,112 @@
+/*
+  This file is part of the Arduino_JSON library.
+  Copyright (c) 2019 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef _JSON_WRITER_H_
+#define _JSON_WRITER_H_
+
+#include <Arduino.h>
+
+#define JSON_WRITER_DEPTH 32   // deepest nesting of objects and arrays
+
+// Writes JSON straight to a Print (Serial, WiFiClient, JSONBuffer, ...) as
+// it is built, without a cJSON tree or an intermediate String.  Commas and
+// quoting are handled; the caller keeps begin/end calls balanced.  Commas
+// are tracked for JSON_WRITER_DEPTH levels of nesting.
+//
+//   JSONWriter json(client);
+//   json.beginObject()
+//       .member("rpm", rpm)
+//       .member("tempC", tempC, 1)      // fixed to 1 decimal
+//       .key("fans").beginArray().value(1).value(2).endArray()
+//     .endObject();
+//
+// Doubles without a decimals argument are written the way cJSON's
+// print_number() does: whole numbers below 1e9 as integers, anything else
+// as the shorter of %1.15g and %1.17g that reads back exactly.  (Some cJSON
+// versions accept a %1.15g that reads back only approximately; there the
+// writer gives 17 digits.)  On AVR, where double is a 32-bit float and
+// printf has no %g, up to 7 significant digits are written in plain
+// notation for magnitudes from 0.001 to 1e7 and in exponent notation
+// outside that.  NaN and infinity, which JSON can't hold, are written as
+// null.  valueRaw() copies text that already is JSON, like cJSON_Raw.
+class JSONWriter {
+public:
+  JSONWriter(Print& out);
+
+  JSONWriter& beginObject();
+  JSONWriter& endObject();
+  JSONWriter& beginArray();
+  JSONWriter& endArray();
+  JSONWriter& key(const char* name);
+
+  JSONWriter& value(bool b);
+  JSONWriter& value(int i);
+  JSONWriter& value(unsigned int i);
+  JSONWriter& value(long l);
+  JSONWriter& value(unsigned long ul);
+  JSONWriter& value(double d);
+  JSONWriter& value(double d, uint8_t decimals);
+  JSONWriter& value(const char* s);
+  JSONWriter& value(const String& s);
+  JSONWriter& valueNull();
+  JSONWriter& valueRaw(const char* json);
+
+  template <typename T>
+  JSONWriter& member(const char* name, T v) { return key(name).value(v); }
+  JSONWriter& member(const char* name, double d, uint8_t decimals) { return key(name).value(d, decimals); }
+
+  size_t written() const { return _written; }
+
+private:
+  void separate();
+  void open(char c);
+  void close(char c);
+  void writeString(const char* s);
+
+  Print& _out;
+  size_t _written;
+  uint8_t _depth;
+  uint32_t _hasItems;  // bit n set once nesting level n has an element
+  bool _afterKey;      // the next value belongs to the key just written
+};
+
+// Print into a fixed buffer, always null-terminated.  Output that doesn't
+// fit is dropped and flagged by overflowed().
+class JSONBuffer : public Print {
+public:
+  JSONBuffer(char* buffer, size_t size);
+
+  virtual size_t write(uint8_t c);
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  using Print::write;
+
+  void clear();
+
+  const char* c_str() const { return _buffer; }
+  size_t length() const { return _length; }
+  bool overflowed() const { return _overflowed; }
+
+private:
+  char* _buffer;
+  size_t _size;
+  size_t _length;
+  bool _overflowed;
+};
+
+#endif
@@ -30,6 +30,34 @@
   UINT32_MAX /**< Used programmatically for timeout.                           \
                    Not a timeout duration. Type: uint32_t. */
 
+DHT *volatile DHT::_capturing = NULL;
+
+/*!
+ *  @brief  Forget a falling edge latched while the interrupt was detached.
+ *          detachInterrupt() leaves the sense control at FALLING, so the
+ *          start signal sets the pin's flag in EIFR, and attachInterrupt()
+ *          would service it at once as a phantom first edge.
+ *  @param  irq
+ *          Arduino interrupt number, as from digitalPinToInterrupt()
+ */
+static void clearPendingEdge(int8_t irq) {
+#if defined(EIFR)
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+  // interrupts 0-5 are INT4, INT5, INT0, INT1, INT2, INT3
+  static const uint8_t flag[] = {INTF4, INTF5, INTF0, INTF1, INTF2, INTF3};
+#elif defined(__AVR_ATmega32U4__)
+  static const uint8_t flag[] = {INTF0, INTF1, INTF2, INTF3, INTF6};
+#else
+  static const uint8_t flag[] = {INTF0, INTF1};
+#endif
+  if (irq >= 0 && (uint8_t)irq < sizeof(flag)) {
+    EIFR = _BV(flag[irq]); // written as 1 to clear
+  }
+#else
+  (void)irq;
+#endif
+}
+
 /*!
  *  @brief  Instantiates a new DHT class
  *  @param  pin
@@ -47,6 +75,17 @@ DHT::DHT(uint8_t pin, uint8_t type, uint8_t count) {
   _bit = digitalPinToBitMask(pin);
   _port = digitalPinToPort(pin);
 #endif
+  _irq = digitalPinToInterrupt(pin);
+  _phase = DHT_IDLE;
+  _interval = MIN_INTERVAL;
+  _lastresult = false;
+  _sample.temperature = NAN;
+  _sample.humidity = NAN;
+  _sample.time = 0;
+  _sample.valid = false;
+  _sample.failures = 0;
+  _preamble = 0;
+  resetStats();
   _maxcycles =
       microsecondsToClockCycles(1000); // 1 millisecond timeout for
                                        // reading pulses from DHT sensor.
@@ -86,39 +125,44 @@ float DHT::readTemperature(bool S, bool force) {
   float f = NAN;
 
   if (read(force)) {
-    switch (_type) {
-    case DHT11:
-      f = data[2];
-      if (data[3] & 0x80) {
-        f = -1 - f;
-      }
-      f += (data[3] & 0x0f) * 0.1;
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT12:
-      f = data[2];
-      f += (data[3] & 0x0f) * 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
-    case DHT22:
-    case DHT21:
-      f = ((word)(data[2] & 0x7F)) << 8 | data[3];
-      f *= 0.1;
-      if (data[2] & 0x80) {
-        f *= -1;
-      }
-      if (S) {
-        f = convertCtoF(f);
-      }
-      break;
+    f = temperatureFromData();
+    if (S) {
+      f = convertCtoF(f);
+    }
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Decode the temperature in the last frame received
+ *	@return Temperature in Celsius
+ */
+float DHT::temperatureFromData() {
+  float f = NAN;
+
+  switch (_type) {
+  case DHT11:
+    f = data[2];
+    if (data[3] & 0x80) {
+      f = -1 - f;
     }
+    f += (data[3] & 0x0f) * 0.1;
+    break;
+  case DHT12:
+    f = data[2];
+    f += (data[3] & 0x0f) * 0.1;
+    if (data[2] & 0x80) {
+      f *= -1;
+    }
+    break;
+  case DHT22:
+  case DHT21:
+    f = ((word)(data[2] & 0x7F)) << 8 | data[3];
+    f *= 0.1;
+    if (data[2] & 0x80) {
+      f *= -1;
+    }
+    break;
   }
   return f;
 }
@@ -148,17 +192,27 @@ float DHT::convertFtoC(float f) { return (f - 32) * 0.55555; }
 float DHT::readHumidity(bool force) {
   float f = NAN;
   if (read(force)) {
-    switch (_type) {
-    case DHT11:
-    case DHT12:
-      f = data[0] + data[1] * 0.1;
-      break;
-    case DHT22:
-    case DHT21:
-      f = ((word)data[0]) << 8 | data[1];
-      f *= 0.1;
-      break;
-    }
+    f = humidityFromData();
+  }
+  return f;
+}
+
+/*!
+ *  @brief  Decode the humidity in the last frame received
+ *	@return float value - humidity in percent
+ */
+float DHT::humidityFromData() {
+  float f = NAN;
+  switch (_type) {
+  case DHT11:
+  case DHT12:
+    f = data[0] + data[1] * 0.1;
+    break;
+  case DHT22:
+  case DHT21:
+    f = ((word)data[0]) << 8 | data[1];
+    f *= 0.1;
+    break;
   }
   return f;
 }
@@ -229,6 +283,12 @@ float DHT::computeHeatIndex(float temperature, float percentHumidity,
  *	@return float value
  */
 bool DHT::read(bool force) {
+  // A read started with startRead() owns the data line until poll() is
+  // done with it.
+  if (_phase != DHT_IDLE) {
+    return _lastresult;
+  }
+
   // Check if sensor was read less than two seconds ago and return early
   // to use last reading.
   uint32_t currenttime = millis();
@@ -255,79 +315,142 @@ bool DHT::read(bool force) {
   // First set data line low for a period according to sensor type
   pinMode(_pin, OUTPUT);
   digitalWrite(_pin, LOW);
+  uint32_t low = startLow();
+  if (low >= 1000) {
+    delay(low / 1000);
+  }
+  delayMicroseconds(low % 1000);
+
+  record(capture());
+  return _lastresult;
+}
+
+/*!
+ *  @brief  Length of the start signal for this sensor type
+ *  @return microseconds the host holds the data line low
+ */
+uint32_t DHT::startLow() {
   switch (_type) {
   case DHT22:
   case DHT21:
-    delayMicroseconds(1100); // data sheet says "at least 1ms"
-    break;
+    return 1100; // data sheet says "at least 1ms"
   case DHT11:
   default:
-    delay(20); // data sheet says at least 18ms, 20ms just to be safe
-    break;
+    return 20000; // data sheet says at least 18ms, 20ms just to be safe
   }
+}
 
-  uint32_t cycles[80];
-  {
-    // End the start signal by setting data line high for 40 microseconds.
-    pinMode(_pin, INPUT_PULLUP);
+/*!
+ *  @brief  End the start signal and time the sensor's reply by polling the
+ *          data line, with interrupts off for the whole frame (~5 ms)
+ *  @return true if 40 bits with a valid checksum were received
+ */
+bool DHT::capture() {
+  // End the start signal by setting data line high for 40 microseconds.
+  pinMode(_pin, INPUT_PULLUP);
 
-    // Delay a moment to let sensor pull data line low.
-    delayMicroseconds(pullTime);
+  // Delay a moment to let sensor pull data line low.
+  delayMicroseconds(pullTime);
 
-    // Now start reading the data line to get the value from the DHT sensor.
+  // Now start reading the data line to get the value from the DHT sensor.
 
-    // Turn off interrupts temporarily because the next sections
-    // are timing critical and we don't want any interruptions.
-    InterruptLock lock;
+  // Turn off interrupts temporarily because the next sections
+  // are timing critical and we don't want any interruptions.
+  InterruptLock lock;
 
-    // First expect a low signal for ~80 microseconds followed by a high signal
-    // for ~80 microseconds again.
-    if (expectPulse(LOW) == TIMEOUT) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for start signal low pulse."));
-      _lastresult = false;
-      return _lastresult;
+  // First expect a low signal for ~80 microseconds followed by a high signal
+  // for ~80 microseconds again.
+  uint32_t response = expectPulse(LOW);
+  if (response == TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for start signal low pulse."));
+    _stats.startTimeouts++;
+    return false;
+  }
+  uint32_t preamble = expectPulse(HIGH);
+  if (preamble == TIMEOUT) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for start signal high pulse."));
+    // a line that was high all along never had a reply
+    if (response == 0) {
+      _stats.startTimeouts++;
+    } else {
+      _stats.preambleTimeouts++;
     }
-    if (expectPulse(HIGH) == TIMEOUT) {
-      DEBUG_PRINTLN(F("DHT timeout waiting for start signal high pulse."));
-      _lastresult = false;
-      return _lastresult;
+    return false;
+  }
+  tunePullTime(response, preamble);
+
+  // A preamble far off the average of earlier good reads was most likely
+  // cut short or stretched by a glitch; keep the threshold near the average.
+  if (_preamble != 0) {
+    if (preamble < _preamble * 3 / 4) {
+      preamble = _preamble * 3 / 4;
+    } else if (preamble > _preamble * 5 / 4) {
+      preamble = _preamble * 5 / 4;
     }
+  }
 
-    // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
-    // microsecond low pulse followed by a variable length high pulse.  If the
-    // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
-    // then it's a 1.  We measure the cycle count of the initial 50us low pulse
-    // and use that to compare to the cycle count of the high pulse to determine
-    // if the bit is a 0 (high state cycle count < low state cycle count), or a
-    // 1 (high state cycle count > low state cycle count). Note that for speed
-    // all the pulses are read into a array and then examined in a later step.
-    for (int i = 0; i < 80; i += 2) {
-      cycles[i] = expectPulse(LOW);
-      cycles[i + 1] = expectPulse(HIGH);
+  // Now read the 40 bits sent by the sensor.  Each bit is sent as a 50
+  // microsecond low pulse followed by a variable length high pulse.  If the
+  // high pulse is ~28 microseconds then it's a 0 and if it's ~70 microseconds
+  // then it's a 1.  The 80 us preamble high pulse, measured with the same
+  // loop, scales the threshold: 5/8 of it is ~50 us, midway between the two
+  // bit lengths.  Each bit is decoded into data as soon as its high pulse
+  // ends; the time that takes only comes out of the following low pulse,
+  // whose length doesn't matter.
+  uint32_t threshold = preamble * 5 / 8;
+  for (uint8_t i = 0; i < 40; ++i) {
+    if (expectPulse(LOW) == TIMEOUT) {
+      DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
+      _stats.bitTimeouts++;
+      return false;
     }
-  } // Timing critical code is now complete.
-
-  // Inspect pulses and determine which ones are 0 (high state cycle count < low
-  // state cycle count), or 1 (high state cycle count > low state cycle count).
-  for (int i = 0; i < 40; ++i) {
-    uint32_t lowCycles = cycles[2 * i];
-    uint32_t highCycles = cycles[2 * i + 1];
-    if ((lowCycles == TIMEOUT) || (highCycles == TIMEOUT)) {
+    uint32_t highCycles = expectPulse(HIGH);
+    if (highCycles == TIMEOUT) {
       DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
-      _lastresult = false;
-      return _lastresult;
+      _stats.bitTimeouts++;
+      return false;
     }
     data[i / 8] <<= 1;
-    // Now compare the low and high cycle times to see if the bit is a 0 or 1.
-    if (highCycles > lowCycles) {
-      // High cycles are greater than 50us low cycle count, must be a 1.
+    if (highCycles > threshold) {
       data[i / 8] |= 1;
     }
-    // Else high cycles are less than (or equal to, a weird case) the 50us low
-    // cycle count so this must be a zero.  Nothing needs to be changed in the
-    // stored data.
   }
 
+  if (!verify()) {
+    return false;
+  }
+  _preamble = _preamble == 0 ? preamble : (3 * _preamble + preamble) / 4;
+  return true;
+}
+
+/*!
+ *  @brief  Nudge pullTime so listening starts early in the sensor's 80 us
+ *          response low pulse, which follows the host's release by 20-40 us
+ *          (longer on long cables)
+ *  @param  response
+ *          loop count of the part of the response low pulse that was seen
+ *  @param  preamble
+ *          loop count of the 80 us preamble high pulse
+ */
+void DHT::tunePullTime(uint32_t response, uint32_t preamble) {
+  if (response == 0) {
+    // the line was still high: the sensor hadn't answered yet
+    if (pullTime + DHT_PULL_STEP <= DHT_PULL_MAX) {
+      pullTime += DHT_PULL_STEP;
+    }
+  } else if (response < preamble / 2) {
+    // more than half of the response was missed
+    if (pullTime >= DHT_PULL_MIN + DHT_PULL_STEP) {
+      pullTime -= DHT_PULL_STEP;
+    }
+  }
+}
+
+/*!
+ *  @brief  Check the checksum of the 40 bits in data
+ *  @return true if it matches
+ */
+bool DHT::verify() {
   DEBUG_PRINTLN(F("Received from DHT:"));
   DEBUG_PRINT(data[0], HEX);
   DEBUG_PRINT(F(", "));
@@ -343,13 +466,201 @@ bool DHT::read(bool force) {
 
   // Check we read 40 bits and that the checksum matches.
   if (data[4] == ((data[0] + data[1] + data[2] + data[3]) & 0xFF)) {
-    _lastresult = true;
-    return _lastresult;
+    return true;
   } else {
     DEBUG_PRINTLN(F("DHT checksum failure!"));
-    _lastresult = false;
-    return _lastresult;
+    _stats.checksumErrors++;
+    return false;
+  }
+}
+
+/*!
+ *  @brief  Start a read without blocking.  The start signal is left running
+ *          and poll() carries the read through; read(), readTemperature()
+ *          and readHumidity() return the previous result in the meantime.
+ *  @param  force
+ *          true to start even if the last read was less than two seconds ago
+ *	@return true if a read was started
+ */
+bool DHT::startRead(bool force) {
+  if (_phase != DHT_IDLE) {
+    return false;
+  }
+  uint32_t currenttime = millis();
+  if (!force && ((currenttime - _lastreadtime) < MIN_INTERVAL)) {
+    return false;
+  }
+  _lastreadtime = currenttime;
+
+  // The line has been idling high on the pull-up since the last read, so
+  // the start signal can begin right away.
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  _phaseStart = micros();
+  _phase = DHT_STARTING;
+  return true;
+}
+
+/*!
+ *  @brief  Clear the read and error counters
+ */
+void DHT::resetStats() {
+  _stats.reads = 0;
+  _stats.startTimeouts = 0;
+  _stats.preambleTimeouts = 0;
+  _stats.bitTimeouts = 0;
+  _stats.checksumErrors = 0;
+}
+
+/*!
+ *  @brief  Set how often poll() refreshes the reading by itself
+ *  @param  ms
+ *          milliseconds between reads, at least two seconds; 0 leaves
+ *          starting reads to startRead() (as DHTBus does)
+ */
+void DHT::setInterval(uint32_t ms) {
+  _interval = (ms != 0 && ms < MIN_INTERVAL) ? MIN_INTERVAL : ms;
+}
+
+/*!
+ *  @brief  Keep the reading fresh in the background.  Call it from loop().
+ *
+ *          When idle, a read is started every setInterval() milliseconds
+ *          (two seconds by default).  Once the start signal has run its length the line is released
+ *          and, if the pin has an external interrupt, the sensor's reply is
+ *          timestamped edge by edge and decoded when complete, so
+ *          interrupts are never held off.  On other pins the reply is timed
+ *          by polling as in read(), which still disables interrupts for the
+ *          frame but no longer blocks for the start signal.
+ *	@return true when a read has finished; the result is then available
+ *          through sample(), read(), readTemperature() and readHumidity()
+ */
+bool DHT::poll() {
+  switch (_phase) {
+  case DHT_IDLE:
+    if (_interval != 0 && millis() - _lastreadtime >= _interval) {
+      startRead(true);
+    }
+    return false;
+
+  case DHT_STARTING:
+    if ((uint32_t)(micros() - _phaseStart) < startLow()) {
+      return false;
+    }
+
+    // only one sensor can be captured at a time, and a polled capture
+    // would hold off another one's edge interrupts; holding the start
+    // signal a little longer is harmless
+    if (_capturing != NULL) {
+      return false;
+    }
+
+    if (_irq == NOT_AN_INTERRUPT) {
+      _capturing = this;
+      record(capture());
+      _capturing = NULL;
+      _phase = DHT_IDLE;
+      return true;
+    }
+
+    _nedges = 0;
+    _capturing = this;
+    pinMode(_pin, INPUT_PULLUP);
+    // the sensor answers 20-40 us after the release, well after this
+    clearPendingEdge(_irq);
+    attachInterrupt(_irq, edgeISR, FALLING);
+    _phaseStart = millis();
+    _phase = DHT_CAPTURING;
+    return false;
+
+  case DHT_CAPTURING:
+    if (_nedges < DHT_EDGES && (millis() - _phaseStart) < DHT_FRAME_TIMEOUT) {
+      return false;
+    }
+    detachInterrupt(_irq);
+    _capturing = NULL;
+    record(takeFrame());
+    _phase = DHT_IDLE;
+    return true;
+  }
+  return false;
+}
+
+/*!
+ *  @brief  Store the outcome of a read and update the sample
+ *  @param  ok
+ *          true if the frame passed its checksum
+ */
+void DHT::record(bool ok) {
+  _lastresult = ok;
+  _sample.valid = ok;
+  if (ok) {
+    _stats.reads++;
+    _sample.temperature = temperatureFromData();
+    _sample.humidity = humidityFromData();
+    _sample.time = millis();
+    _sample.failures = 0;
+  } else if (_sample.failures < 255) {
+    _sample.failures++;
+  }
+}
+
+/*!
+ *  @brief  Falling edge interrupt of the sensor being captured.  Bits are
+ *          told apart by their period from falling edge to falling edge: a
+ *          50 us low followed by a ~28 us high for a 0 or a ~70 us high for
+ *          a 1.  The preamble (80 us low + 80 us high) between the first two
+ *          edges sets the threshold, so the sensor's clock tolerance cancels
+ *          out.  Each bit goes straight into _frame.
+ */
+void DHT::edgeISR() {
+  DHT *dht = _capturing;
+  if (dht == NULL || dht->_nedges >= DHT_EDGES) {
+    return;
+  }
+  uint16_t now = (uint16_t)micros();
+  uint16_t period = now - dht->_lastEdge;
+  uint8_t n = dht->_nedges;
+  if (n == 1) {
+    // nominally 100 us; clamped in case the first edge was missed
+    uint16_t threshold = period * 5 / 8;
+    if (threshold < DHT_PERIOD_MIN) {
+      threshold = DHT_PERIOD_MIN;
+    } else if (threshold > DHT_PERIOD_MAX) {
+      threshold = DHT_PERIOD_MAX;
+    }
+    dht->_threshold = threshold;
+  } else if (n >= 2) {
+    uint8_t i = n - 2;
+    dht->_frame[i / 8] <<= 1;
+    if (period > dht->_threshold) {
+      dht->_frame[i / 8] |= 1;
+    }
+  }
+  dht->_lastEdge = now;
+  dht->_nedges = n + 1;
+}
+
+/*!
+ *  @brief  Check the bits edgeISR() decoded
+ *	@return true if the frame was complete and the checksum matches
+ */
+bool DHT::takeFrame() {
+  if (_nedges < DHT_EDGES) {
+    DEBUG_PRINTLN(F("DHT timeout waiting for pulse."));
+    if (_nedges == 0) {
+      _stats.startTimeouts++;
+    } else if (_nedges < 2) {
+      _stats.preambleTimeouts++;
+    } else {
+      _stats.bitTimeouts++;
+    }
+    return false;
+  }
+  for (uint8_t i = 0; i < 5; i++) {
+    data[i] = _frame[i];
   }
+  return verify();
 }
 
 // Expect the signal line to be at the specified level for a period of time and
@@ -47,6 +47,22 @@ static const uint8_t DHT21{21};  /**< DHT TYPE 21 */
 static const uint8_t DHT22{22};  /**< DHT TYPE 22 */
 static const uint8_t AM2301{21}; /**< AM2301 */
 
+/* Phases of a read started with startRead(). */
+#define DHT_IDLE 0      /**< No read in progress */
+#define DHT_STARTING 1  /**< Host is holding the data line low */
+#define DHT_CAPTURING 2 /**< Sensor is sending, falling edges are timestamped */
+
+#define DHT_EDGES                                                              \
+  42 /**< Falling edges in a frame: response, end of preamble, 40 bits */
+#define DHT_FRAME_TIMEOUT 10 /**< ms allowed for the sensor to send a frame */
+
+/* Bounds for the self-tuning timing. */
+#define DHT_PULL_MIN 20  /**< Shortest pullTime (us) */
+#define DHT_PULL_MAX 80  /**< Longest pullTime (us) */
+#define DHT_PULL_STEP 5  /**< pullTime change (us) per adjustment */
+#define DHT_PERIOD_MIN 88  /**< Lowest bit-period threshold (us), ISR path */
+#define DHT_PERIOD_MAX 112 /**< Highest bit-period threshold (us), ISR path */
+
 #if defined(TARGET_NAME) && (TARGET_NAME == ARDUINO_NANO33BLE)
 #ifndef microsecondsToClockCycles
 /*!
@@ -57,6 +73,41 @@ static const uint8_t AM2301{21}; /**< AM2301 */
 #endif
 #endif
 
+/*!
+ *  @brief  Latest reading of a DHT with its age and status, see DHT::sample()
+ */
+struct DHTSample {
+  float temperature; /**< Celsius, from the last good read; NAN before one */
+  float humidity;    /**< Percent, from the last good read; NAN before one */
+  uint32_t time;     /**< millis() of the last good read */
+  bool valid;        /**< The most recent read passed its checksum */
+  uint8_t failures;  /**< Consecutive failed reads, saturates at 255 */
+
+  /*!
+   *  @brief  Time since the last good read
+   *  @return age in milliseconds
+   */
+  uint32_t age() const { return millis() - time; }
+  /*!
+   *  @brief  Check whether the values are too old to act on
+   *  @param  maxAge
+   *          oldest acceptable reading, in milliseconds
+   *  @return true if there was no good read within maxAge
+   */
+  bool stale(uint32_t maxAge) const { return isnan(humidity) || age() > maxAge; }
+};
+
+/*!
+ *  @brief  Outcome counters of a DHT, see DHT::stats()
+ */
+struct DHTStats {
+  uint16_t reads;            /**< Reads that passed the checksum */
+  uint16_t startTimeouts;    /**< No reply to the start signal */
+  uint16_t preambleTimeouts; /**< Reply stopped within the preamble */
+  uint16_t bitTimeouts;      /**< Frame cut off within the 40 bits */
+  uint16_t checksumErrors;   /**< Complete frames with a bad checksum */
+};
+
 /*!
  *  @brief  Class that stores state and functions for DHT
  */
@@ -72,6 +123,31 @@ public:
                          bool isFahrenheit = true);
   float readHumidity(bool force = false);
   bool read(bool force = false);
+  bool startRead(bool force = false);
+  bool poll();
+  /*!
+   *  @brief  Check for a read started with startRead() that poll() has not
+   *          finished yet
+   *  @return true while the data line is owned by that read
+   */
+  bool busy() { return _phase != DHT_IDLE; }
+  void setInterval(uint32_t ms);
+  /*!
+   *  @brief  Latest reading without touching the sensor
+   *  @return the cached sample, refreshed by poll() and read()
+   */
+  const DHTSample &sample() { return _sample; }
+  /*!
+   *  @brief  Read and error counters, e.g. to find a marginal sensor
+   *  @return counters since construction or resetStats()
+   */
+  const DHTStats &stats() { return _stats; }
+  void resetStats();
+  /*!
+   *  @brief  Current pull-up time, as tuned from the sensor's replies
+   *  @return microseconds between releasing the line and listening
+   */
+  uint8_t pullUpTime() { return pullTime; }
 
 private:
   uint8_t data[5];
@@ -84,8 +160,34 @@ private:
 #endif
   uint32_t _lastreadtime, _maxcycles;
   bool _lastresult;
+  uint32_t _interval; // ms between the reads poll() starts by itself
+  DHTSample _sample;
+  DHTStats _stats;
+  uint32_t _preamble; // average preamble loop count of good polled reads
   uint8_t pullTime; // Time (in usec) to pull up data line before reading
 
+  // Non-blocking read state.  edgeISR() decodes the frame of the sensor in
+  // _capturing into _frame as its falling edges come in; data keeps the
+  // previous reading until the frame is complete.  A polled capture claims
+  // _capturing too, as it holds interrupts off.
+  uint8_t _phase;
+  uint32_t _phaseStart;
+  int8_t _irq; // external interrupt of _pin, or NOT_AN_INTERRUPT
+  volatile uint8_t _nedges;
+  uint16_t _lastEdge;  // low 16 bits of micros() at the previous edge
+  uint16_t _threshold; // bit period (us) above which a bit is a 1
+  uint8_t _frame[5];
+  static DHT *volatile _capturing;
+
+  static void edgeISR();
+  uint32_t startLow();
+  bool capture();
+  bool takeFrame();
+  bool verify();
+  void record(bool ok);
+  void tunePullTime(uint32_t response, uint32_t preamble);
+  float temperatureFromData();
+  float humidityFromData();
   uint32_t expectPulse(bool level);
 };
 
@@ -0,0 +1,167 @@
+/*!
+ *  @file DHTApparent.cpp
+ *
+ *  Heat index and dew point without floating point.  Both come from
+ *  tables in flash, sampled over the DHT11's range (0-50 C), and are
+ *  bilinearly interpolated in between.  All values are in tenths: 253 is
+ *  25.3 C or 25.3 %.  Inputs outside a table are clamped to its edge.
+ *
+ *  The heat index table holds DHT::computeHeatIndex(t, rh, false), the
+ *  NWS Steadman/Rothfusz formula, every 2.5 C and 10 %RH.  The result is
+ *  within 0.6 C of it except from 24 to 27.5 C, where the formula switches
+ *  to the Rothfusz regression and itself jumps by up to 1.2 C; there the
+ *  table is within 0.9 C.  The dew point table holds
+ *  dhtDewPointReference() every 5 C and 5 %RH from 10 %RH up, within
+ *  0.35 C.
+ *
+ *  On AVR the float formula takes a few milliseconds per call; a table
+ *  lookup takes a few microseconds, so it can run on every control tick.
+ */
+
+#include "DHTApparent.h"
+
+#define HI_T_STEP 25 /**< Heat index table temperature step, tenths C */
+#define HI_T_ROWS 21 /**< 0 to 50 C */
+#define HI_H_MIN 0   /**< Heat index table first humidity, tenths % */
+#define HI_H_STEP 100
+#define HI_H_COLS 11 /**< 0 to 100 % */
+
+#define DP_T_STEP 50
+#define DP_T_ROWS 11  /**< 0 to 50 C */
+#define DP_H_MIN 100  /**< Dew point is undefined at 0 %, start at 10 % */
+#define DP_H_STEP 50
+#define DP_H_COLS 19  /**< 10 to 100 % */
+
+static const int16_t heatIndexTable[HI_T_ROWS * HI_H_COLS] PROGMEM = {
+    -39, -37, -34, -32, -29, -26, -24, -21, -19, -16, -13,  // 0 C
+    -12, -9, -7, -4, -1, 1, 4, 6, 9, 12, 14,  // 2.5 C
+    16, 18, 21, 23, 26, 29, 31, 34, 36, 39, 42,  // 5 C
+    43, 46, 48, 51, 53, 56, 59, 61, 64, 67, 69,  // 7.5 C
+    71, 73, 76, 78, 81, 84, 86, 89, 91, 94, 97,  // 10 C
+    98, 101, 103, 106, 108, 111, 114, 116, 119, 122, 124,  // 12.5 C
+    126, 128, 131, 133, 136, 139, 141, 144, 146, 149, 152,  // 15 C
+    153, 156, 158, 161, 163, 166, 169, 171, 174, 177, 179,  // 17.5 C
+    181, 183, 186, 188, 191, 194, 196, 199, 201, 204, 207,  // 20 C
+    208, 211, 213, 216, 218, 221, 224, 226, 229, 232, 234,  // 22.5 C
+    236, 238, 241, 243, 246, 249, 251, 254, 256, 259, 253,  // 25 C
+    254, 260, 264, 267, 272, 279, 287, 297, 309, 325, 346,  // 27.5 C
+    272, 279, 282, 288, 297, 310, 328, 350, 377, 408, 444,  // 30 C
+    290, 298, 305, 314, 330, 353, 383, 419, 462, 512, 569,  // 32.5 C
+    307, 319, 330, 347, 372, 407, 450, 503, 565, 637, 717,  // 35 C
+    328, 342, 360, 386, 423, 472, 532, 603, 686, 781, 887,  // 37.5 C
+    347, 367, 394, 431, 483, 548, 626, 719, 825, 945, 1079,  // 40 C
+    366, 393, 431, 483, 551, 635, 735, 850, 981, 1129, 1292,  // 42.5 C
+    388, 421, 472, 541, 628, 733, 856, 997, 1156, 1332, 1527,  // 45 C
+    400, 449, 517, 606, 714, 843, 991, 1159, 1347, 1555, 1783,  // 47.5 C
+    410, 477, 566, 677, 809, 964, 1140, 1337, 1557, 1798, 2062,  // 50 C
+};
+
+static const int16_t dewPointTable[DP_T_ROWS * DP_H_COLS] PROGMEM = {
+    -281, -236, -203, -177, -155, -137, -120, -105, -92, -80, -68, -58, -48, -39, -30, -22, -14, -7, 0,  // 0 C
+    -242, -196, -162, -134, -112, -92, -75, -60, -46, -33, -21, -10, 0, 9, 18, 27, 35, 43, 50,  // 5 C
+    -203, -155, -120, -92, -68, -48, -30, -14, 0, 14, 26, 37, 48, 58, 67, 76, 84, 92, 100,  // 10 C
+    -164, -115, -78, -49, -25, -4, 15, 32, 47, 60, 73, 85, 96, 106, 116, 125, 134, 142, 150,  // 15 C
+    -126, -75, -37, -6, 19, 41, 60, 77, 93, 107, 120, 132, 144, 154, 164, 174, 183, 192, 200,  // 20 C
+    -88, -35, 5, 36, 62, 85, 105, 122, 139, 153, 167, 180, 191, 203, 213, 223, 232, 241, 250,  // 25 C
+    -50, 5, 46, 78, 105, 129, 149, 168, 184, 200, 214, 227, 239, 251, 262, 272, 282, 291, 300,  // 30 C
+    -12, 45, 87, 120, 148, 173, 194, 213, 230, 246, 261, 274, 287, 299, 310, 321, 331, 341, 350,  // 35 C
+    26, 85, 128, 162, 191, 216, 238, 258, 276, 292, 308, 322, 335, 347, 359, 370, 380, 390, 400,  // 40 C
+    64, 124, 169, 204, 234, 260, 283, 303, 322, 339, 354, 369, 383, 395, 407, 419, 430, 440, 450,  // 45 C
+    101, 163, 209, 246, 277, 304, 327, 348, 367, 385, 401, 416, 430, 443, 456, 468, 479, 490, 500,  // 50 C
+};
+
+/*!
+ *  @brief  Bilinear interpolation in a table of tenths in flash
+ *  @param  table
+ *          rows * cols values, one row per temperature
+ *  @param  rows
+ *          number of temperatures
+ *  @param  cols
+ *          number of humidities
+ *  @param  x
+ *          temperature offset from the first row, in tenths
+ *  @param  xStep
+ *          temperature step between rows, in tenths
+ *  @param  y
+ *          humidity offset from the first column, in tenths
+ *  @param  yStep
+ *          humidity step between columns, in tenths
+ *  @return interpolated value, rounded to the nearest tenth
+ */
+static int16_t interpolate(const int16_t *table, uint8_t rows, uint8_t cols,
+                           int16_t x, int16_t xStep, int16_t y, int16_t yStep) {
+  if (x < 0) {
+    x = 0;
+  } else if (x > (rows - 1) * xStep) {
+    x = (rows - 1) * xStep;
+  }
+  if (y < 0) {
+    y = 0;
+  } else if (y > (cols - 1) * yStep) {
+    y = (cols - 1) * yStep;
+  }
+
+  // cell and position within it; the last row/column uses the cell before
+  uint8_t i = x / xStep;
+  uint8_t j = y / yStep;
+  if (i == rows - 1) {
+    i--;
+  }
+  if (j == cols - 1) {
+    j--;
+  }
+  int32_t fx = x - i * xStep;
+  int32_t fy = y - j * yStep;
+
+  const int16_t *p = table + i * cols + j;
+  int32_t v00 = (int16_t)pgm_read_word(p);
+  int32_t v01 = (int16_t)pgm_read_word(p + 1);
+  int32_t v10 = (int16_t)pgm_read_word(p + cols);
+  int32_t v11 = (int16_t)pgm_read_word(p + cols + 1);
+
+  int32_t a = v00 * (yStep - fy) + v01 * fy;
+  int32_t b = v10 * (yStep - fy) + v11 * fy;
+  int32_t scale = (int32_t)xStep * yStep;
+  int32_t v = a * (xStep - fx) + b * fx;
+  return (int16_t)((v >= 0 ? v + scale / 2 : v - scale / 2) / scale);
+}
+
+/*!
+ *  @brief  Heat index (apparent temperature) from a table lookup
+ *  @param  tempC10
+ *          air temperature in tenths of a degree Celsius
+ *  @param  humidity10
+ *          relative humidity in tenths of a percent
+ *  @return heat index in tenths of a degree Celsius
+ */
+int16_t dhtHeatIndex10(int16_t tempC10, uint16_t humidity10) {
+  return interpolate(heatIndexTable, HI_T_ROWS, HI_H_COLS, tempC10,
+                     HI_T_STEP, (int16_t)humidity10 - HI_H_MIN, HI_H_STEP);
+}
+
+/*!
+ *  @brief  Dew point from a table lookup
+ *  @param  tempC10
+ *          air temperature in tenths of a degree Celsius
+ *  @param  humidity10
+ *          relative humidity in tenths of a percent, 10 % or more
+ *  @return dew point in tenths of a degree Celsius
+ */
+int16_t dhtDewPoint10(int16_t tempC10, uint16_t humidity10) {
+  return interpolate(dewPointTable, DP_T_ROWS, DP_H_COLS, tempC10, DP_T_STEP,
+                     (int16_t)humidity10 - DP_H_MIN, DP_H_STEP);
+}
+
+/*!
+ *  @brief  Dew point by the Magnus formula (Sonntag 1990 constants); the
+ *          reference dewPointTable was generated from
+ *  @param  tempC
+ *          air temperature in degrees Celsius
+ *  @param  humidity
+ *          relative humidity in percent
+ *  @return dew point in degrees Celsius
+ */
+float dhtDewPointReference(float tempC, float humidity) {
+  float g = log(humidity / 100.0) + 17.62 * tempC / (243.12 + tempC);
+  return 243.12 * g / (17.62 - g);
+}
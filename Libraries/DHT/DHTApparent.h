@@ -0,0 +1,16 @@
+/*!
+ *  @file DHTApparent.h
+ *
+ *  Fixed-point heat index and dew point for DHT readings.
+ */
+
+#ifndef DHTAPPARENT_H
+#define DHTAPPARENT_H
+
+#include "Arduino.h"
+
+int16_t dhtHeatIndex10(int16_t tempC10, uint16_t humidity10);
+int16_t dhtDewPoint10(int16_t tempC10, uint16_t humidity10);
+float dhtDewPointReference(float tempC, float humidity);
+
+#endif
@@ -0,0 +1,108 @@
+/*!
+ *  @file DHTBus.cpp
+ *
+ *  Round-robin reads of several DHT sensors on separate pins.
+ */
+
+#include "DHTBus.h"
+
+/*! Reported for channels that don't exist */
+static const DHTSample noSample = {NAN, NAN, 0, false, 0};
+
+/*!
+ *  @brief  Instantiates an empty bus
+ *  @param  interval
+ *          ms between the starts of two rounds, at least two seconds
+ */
+DHTBus::DHTBus(uint32_t interval) {
+  _count = 0;
+  _interval = interval < 2000 ? 2000 : interval;
+  _roundTime = 0;
+  _started = 0;
+  _pending = 0;
+  _running = false;
+}
+
+/*!
+ *  @brief  Hand a sensor over to the bus.  Call the sensor's begin() first;
+ *          from then on only the bus starts its reads.
+ *  @param  sensor
+ *          sensor to add
+ *  @return channel number for sample(), reads() and failures(), or
+ *          DHT_BUS_INVALID if the bus already has DHT_BUS_MAX sensors
+ */
+uint8_t DHTBus::add(DHT &sensor) {
+  if (_count >= DHT_BUS_MAX) {
+    return DHT_BUS_INVALID;
+  }
+  uint8_t channel = _count++;
+  _channels[channel].sensor = &sensor;
+  _channels[channel].reads = 0;
+  _channels[channel].failures = 0;
+  sensor.setInterval(0);
+
+  // the first round starts on the next poll()
+  _roundStart = millis() - _interval;
+  return channel;
+}
+
+/*!
+ *  @brief  Latest reading of one sensor
+ *  @param  channel
+ *          value returned by add()
+ *  @return the sensor's cached sample; for an invalid channel, a sample
+ *          with NAN values that is never valid
+ */
+const DHTSample &DHTBus::sample(uint8_t channel) {
+  if (channel >= _count) {
+    return noSample;
+  }
+  return _channels[channel].sensor->sample();
+}
+
+/*!
+ *  @brief  Advance the current round.  Call it from loop().
+ *  @return true when a round has just completed
+ */
+bool DHTBus::poll() {
+  uint32_t now = millis();
+
+  if (!_running) {
+    if (_count == 0 || now - _roundStart < _interval) {
+      return false;
+    }
+    _roundStart = now;
+    _started = 0;
+    _pending = 0;
+    _running = true;
+  }
+
+  // start signals go out DHT_BUS_STAGGER ms apart
+  while (_started < _count && now - _roundStart >= (uint32_t)_started * DHT_BUS_STAGGER) {
+    if (_channels[_started].sensor->startRead(true)) {
+      _pending |= 1 << _started;
+    }
+    _started++;
+  }
+
+  for (uint8_t i = 0; i < _started; i++) {
+    if (!(_pending & (1 << i))) {
+      continue;
+    }
+    Channel &c = _channels[i];
+    if (c.sensor->poll()) {
+      _pending &= ~(1 << i);
+      c.reads++;
+      if (!c.sensor->sample().valid) {
+        c.failures++;
+      }
+    }
+  }
+
+  if (_started < _count || _pending != 0) {
+    return false;
+  }
+  _running = false;
+  _roundTime = millis() - _roundStart;
+  return true;
+}
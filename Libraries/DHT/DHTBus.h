@@ -0,0 +1,83 @@
+/*!
+ *  @file DHTBus.h
+ *
+ *  Round-robin reads of several DHT sensors on separate pins.
+ */
+
+#ifndef DHTBUS_H
+#define DHTBUS_H
+
+#include "DHT.h"
+
+#define DHT_BUS_MAX 4 /**< Sensors per bus */
+#define DHT_BUS_INVALID                                                        \
+  0xFF /**< add() on a full bus; the accessors report no data for it */
+#define DHT_BUS_STAGGER                                                        \
+  6 /**< ms between start signals, a little over one frame capture */
+
+/*!
+ *  @brief  Reads a group of DHT sensors together.
+ *
+ *  Each round starts the sensors' start signals DHT_BUS_STAGGER ms apart
+ *  rather than one read after another.  Their 18-20 ms wake windows
+ *  overlap, while their ~5 ms replies still arrive one at a time, so they
+ *  share the single capture slot (and ISR) in the DHT class.  A round of N
+ *  DHT11s takes about 25 + 6 * (N - 1) ms instead of 25 * N ms, all of it
+ *  in the background.
+ */
+class DHTBus {
+public:
+  DHTBus(uint32_t interval = 2000);
+
+  uint8_t add(DHT &sensor);
+  bool poll();
+
+  /*!
+   *  @brief  Number of sensors added
+   *  @return sensor count
+   */
+  uint8_t count() { return _count; }
+  const DHTSample &sample(uint8_t channel);
+  /*!
+   *  @brief  Reads of one sensor since it was added
+   *  @param  channel
+   *          value returned by add()
+   *  @return completed reads, good or bad; 0 for an invalid channel
+   */
+  uint16_t reads(uint8_t channel) {
+    return channel < _count ? _channels[channel].reads : 0;
+  }
+  /*!
+   *  @brief  Failed reads of one sensor since it was added
+   *  @param  channel
+   *          value returned by add()
+   *  @return reads with a timeout or checksum error; 0 for an invalid
+   *          channel
+   */
+  uint16_t failures(uint8_t channel) {
+    return channel < _count ? _channels[channel].failures : 0;
+  }
+  /*!
+   *  @brief  Duration of the last complete round
+   *  @return ms from the first start signal to the last sensor finishing
+   */
+  uint32_t roundTime() { return _roundTime; }
+
+private:
+  struct Channel {
+    DHT *sensor;
+    uint16_t reads;
+    uint16_t failures;
+  };
+
+  Channel _channels[DHT_BUS_MAX];
+  uint8_t _count;
+  uint32_t _interval;
+  uint32_t _roundStart; // millis() at the first start signal
+  uint32_t _roundTime;
+  uint8_t _started;     // sensors started in this round
+  uint8_t _pending;     // bitmask of sensors still reading
+  bool _running;
+};
+
+#endif
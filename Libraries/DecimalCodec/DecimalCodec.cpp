@@ -0,0 +1,378 @@
+/*!
+ *  @file DecimalCodec.cpp
+ *
+ *  Decimal parsing and formatting without the C library's locale handling
+ *  or digit-by-digit floating point.  Digits are gathered in an integer;
+ *  floating point is touched once per number, if at all.
+ */
+
+#include "DecimalCodec.h"
+
+#if defined(__AVR__)
+typedef uint32_t decimal_uint_t; /**< Mantissa and fixed-point magnitude */
+#define DECIMAL_EXACT_MAX 16777216UL /**< 2^24, largest exact float integer */
+#define DECIMAL_POW10_MAX 10         /**< 1e10 is the largest exact float */
+#else
+typedef uint64_t decimal_uint_t; /**< Mantissa and fixed-point magnitude */
+#define DECIMAL_EXACT_MAX 9007199254740992ULL /**< 2^53 */
+#define DECIMAL_POW10_MAX 22                  /**< 1e22 is exact in a double */
+#endif
+
+static const double decimalPow10[DECIMAL_POW10_MAX + 1] PROGMEM = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+#if DECIMAL_POW10_MAX > 10
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+#endif
+};
+
+static const uint32_t decimalScale[DECIMAL_DECIMALS_MAX + 1] PROGMEM = {
+    1UL,      10UL,      100UL,      1000UL,      10000UL,
+    100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+
+#if defined(__AVR__)
+#define POW10(i) pgm_read_float(&decimalPow10[i])
+#define SCALE(i) pgm_read_dword(&decimalScale[i])
+#else
+#define POW10(i) decimalPow10[i]
+#define SCALE(i) decimalScale[i]
+#endif
+
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+/*!
+ *  @brief  Shift a decimal digit into a fixed-point magnitude
+ *  @return false, with magnitude saturated, if it would pass 2^31 - 1
+ */
+static bool shiftDigit(decimal_uint_t &magnitude, uint8_t digit) {
+  if (magnitude > (0x7FFFFFFFUL - digit) / 10) {
+    magnitude = 0x7FFFFFFFUL;
+    return false;
+  }
+  magnitude = magnitude * 10 + digit;
+  return true;
+}
+
+/*!
+ *  @brief  Match JSON's number grammar,
+ *          -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+ *  @param  s
+ *          text
+ *  @return true if s starts with a number in that grammar that isn't
+ *          directly followed by more digits, '.' or an exponent
+ */
+static bool isJSONNumber(const char *s) {
+  const char *p = s;
+
+  if (*p == '-') {
+    p++;
+  }
+  if (*p == '0') {
+    p++;
+  } else if (isDigit(*p)) {
+    while (isDigit(*p)) {
+      p++;
+    }
+  } else {
+    return false;
+  }
+
+  if (*p == '.') {
+    p++;
+    if (!isDigit(*p)) {
+      return false;
+    }
+    while (isDigit(*p)) {
+      p++;
+    }
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    p++;
+    if (*p == '-' || *p == '+') {
+      p++;
+    }
+    if (!isDigit(*p)) {
+      return false;
+    }
+    while (isDigit(*p)) {
+      p++;
+    }
+  }
+
+  // "01" and "1.2.3" stop short of the digits and dots that follow
+  return !isDigit(*p) && *p != '.';
+}
+
+/*!
+ *  @brief  Parse a decimal number such as "-84.388" or "2.5e-3"
+ *  @param  s
+ *          text; leading whitespace is not skipped
+ *  @param  end
+ *          if not NULL, set to the first character after the number, or to
+ *          s if there was no number
+ *  @param  strict
+ *          true to accept only JSON's number grammar: no '+' sign, no
+ *          leading zeros, digits on both sides of a '.', digits after an
+ *          exponent.  Anything else, such as "-.5", "1." or "01", is no
+ *          number.
+ *  @return the value, correctly rounded; 0 if there was no number
+ */
+double decimalParse(const char *s, const char **end, bool strict) {
+  if (strict && !isJSONNumber(s)) {
+    if (end) {
+      *end = s;
+    }
+    return 0;
+  }
+
+  const char *p = s;
+  bool negative = (*p == '-');
+  decimal_uint_t mantissa = 0;
+  int exponent = 0;
+  bool digits = false;
+  bool exact = true;
+
+  if (*p == '-' || *p == '+') {
+    p++;
+  }
+
+  for (; isDigit(*p); p++) {
+    digits = true;
+    if (mantissa < DECIMAL_EXACT_MAX / 10) {
+      mantissa = mantissa * 10 + (*p - '0');
+    } else {
+      exact = false;
+    }
+  }
+
+  if (*p == '.') {
+    for (p++; isDigit(*p); p++) {
+      digits = true;
+      if (mantissa < DECIMAL_EXACT_MAX / 10) {
+        mantissa = mantissa * 10 + (*p - '0');
+        exponent--;
+      } else if (*p != '0') {
+        exact = false;
+      }
+    }
+  }
+
+  if (!digits) {
+    if (end) {
+      *end = s;
+    }
+    return 0;
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    const char *q = p + 1;
+    bool negativeExponent = (*q == '-');
+    int e = 0;
+
+    if (*q == '-' || *q == '+') {
+      q++;
+    }
+    if (isDigit(*q)) {
+      for (; isDigit(*q); q++) {
+        if (e < 1000) {
+          e = e * 10 + (*q - '0');
+        }
+      }
+      exponent += negativeExponent ? -e : e;
+      p = q;
+    }
+  }
+
+  if (end) {
+    *end = p;
+  }
+
+  // Clinger's fast path: both operands exact, so one rounding
+  if (exact && exponent >= -DECIMAL_POW10_MAX && exponent <= DECIMAL_POW10_MAX) {
+    double value = (double)mantissa;
+
+    if (exponent < 0) {
+      value /= POW10(-exponent);
+    } else {
+      value *= POW10(exponent);
+    }
+    return negative ? -value : value;
+  }
+
+  return strtod(s, NULL);
+}
+
+/*!
+ *  @brief  Parse a decimal number into fixed point, e.g. "23.456" with 2
+ *          decimals gives 2346
+ *  @param  s
+ *          text; leading whitespace is not skipped, exponents are not read
+ *  @param  decimals
+ *          fraction digits kept, up to DECIMAL_DECIMALS_MAX; the next digit
+ *          rounds half away from zero
+ *  @param  value
+ *          set to the result
+ *  @param  end
+ *          if not NULL, set to the first character after the number
+ *  @return false if there was no number or it doesn't fit in 32 bits
+ */
+bool decimalParseFixed(const char *s, uint8_t decimals, int32_t &value,
+                       const char **end) {
+  const char *p = s;
+  bool negative = (*p == '-');
+  decimal_uint_t magnitude = 0;
+  bool digits = false;
+  bool overflow = false;
+  uint8_t fraction = 0;
+
+  if (decimals > DECIMAL_DECIMALS_MAX) {
+    decimals = DECIMAL_DECIMALS_MAX;
+  }
+  if (*p == '-' || *p == '+') {
+    p++;
+  }
+
+  for (; isDigit(*p); p++) {
+    digits = true;
+    overflow |= !shiftDigit(magnitude, *p - '0');
+  }
+
+  if (*p == '.') {
+    for (p++; isDigit(*p); p++) {
+      digits = true;
+      if (fraction < decimals) {
+        overflow |= !shiftDigit(magnitude, *p - '0');
+        fraction++;
+      } else if (fraction == decimals) {
+        // the first dropped digit rounds
+        if (*p >= '5') {
+          overflow |= (magnitude == 0x7FFFFFFFUL);
+          magnitude += (magnitude < 0x7FFFFFFFUL);
+        }
+        fraction++;
+      }
+    }
+  }
+
+  if (end) {
+    *end = digits ? p : s;
+  }
+  if (!digits) {
+    return false;
+  }
+
+  // pad the fraction out to the requested decimals
+  for (; fraction < decimals; fraction++) {
+    overflow |= !shiftDigit(magnitude, 0);
+  }
+
+  value = negative ? -(int32_t)magnitude : (int32_t)magnitude;
+  return !overflow;
+}
+
+/*!
+ *  @brief  Format a fixed-point value, e.g. 2346 with 2 decimals is "23.46"
+ *  @param  buffer
+ *          output, at least DECIMAL_BUFFER_SIZE characters
+ *  @param  value
+ *          the value times 10^decimals
+ *  @param  decimals
+ *          fraction digits, up to DECIMAL_DECIMALS_MAX
+ *  @return characters written, not counting the terminating null
+ */
+size_t decimalFormatFixed(char *buffer, int32_t value, uint8_t decimals) {
+  char digits[12];
+  uint8_t n = 0;
+  uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+  char *p = buffer;
+
+  if (decimals > DECIMAL_DECIMALS_MAX) {
+    decimals = DECIMAL_DECIMALS_MAX;
+  }
+
+  // at least one integer digit, plus the fraction
+  do {
+    digits[n++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude || n <= decimals);
+
+  if (value < 0) {
+    *p++ = '-';
+  }
+  while (n) {
+    if (n == decimals) {
+      *p++ = '.';
+    }
+    *p++ = digits[--n];
+  }
+  *p = '\0';
+
+  return p - buffer;
+}
+
+/*!
+ *  @brief  Format a number with a fixed count of decimals, like
+ *          Print::print(value, decimals)
+ *  @param  buffer
+ *          output, at least DECIMAL_BUFFER_SIZE characters
+ *  @param  value
+ *          the number; values too large for 32-bit fixed point are written
+ *          in exponent form
+ *  @param  decimals
+ *          fraction digits, up to DECIMAL_DECIMALS_MAX
+ *  @return characters written, not counting the terminating null
+ */
+size_t decimalFormat(char *buffer, double value, uint8_t decimals) {
+  if (isnan(value)) {
+    strcpy(buffer, "nan");
+    return 3;
+  }
+  if (isinf(value)) {
+    strcpy(buffer, value < 0 ? "-inf" : "inf");
+    return strlen(buffer);
+  }
+
+  if (decimals > DECIMAL_DECIMALS_MAX) {
+    decimals = DECIMAL_DECIMALS_MAX;
+  }
+
+  double scaled = value * SCALE(decimals);
+
+  if (scaled > -2147483647.0 && scaled < 2147483647.0) {
+    int32_t fixed = (int32_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    size_t length = decimalFormatFixed(buffer, fixed, decimals);
+
+    // keep the sign of small negatives that round to zero, as print() does
+    if (value < 0 && fixed == 0) {
+      memmove(buffer + 1, buffer, length + 1);
+      buffer[0] = '-';
+      length++;
+    }
+    return length;
+  }
+
+#if defined(__AVR__)
+  dtostre(value, buffer, decimals, 0);
+#else
+  snprintf(buffer, DECIMAL_BUFFER_SIZE, "%.*e", decimals, value);
+#endif
+  return strlen(buffer);
+}
+
+/*!
+ *  @brief  Print a number with a fixed count of decimals, a drop-in for
+ *          Print::print(value, decimals)
+ *  @param  out
+ *          where to print
+ *  @param  value
+ *          the number
+ *  @param  decimals
+ *          fraction digits, up to DECIMAL_DECIMALS_MAX
+ *  @return characters printed
+ */
+size_t decimalPrint(Print &out, double value, uint8_t decimals) {
+  char buffer[DECIMAL_BUFFER_SIZE];
+  size_t length = decimalFormat(buffer, value, decimals);
+
+  return out.write((const uint8_t *)buffer, length);
+}
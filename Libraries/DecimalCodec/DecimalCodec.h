@@ -0,0 +1,39 @@
+/*!
+ *  @file DecimalCodec.h
+ *
+ *  Locale-free decimal text <-> number conversion for sensor and weather
+ *  values, shared by the sketches and the JSON library.
+ *
+ *  Parsing takes Clinger's fast path: when the digits fit exactly in a
+ *  double's mantissa and the power of ten is exact too, one multiply or
+ *  divide gives the correctly rounded result.  That covers readings such as
+ *  "298.48" or "-84.388" on the ESP8266; anything else goes to strtod().
+ *  On AVR, where double is a 32-bit float, the fast path holds up to 7
+ *  digits.  Fixed-point parsing and formatting use integer arithmetic only.
+ *
+ *  By default the parsers take the loose grammar of strtod() without hex
+ *  or inf/nan: a leading '+', leading zeros, and ".5" or "1." are all
+ *  accepted, and parsing stops before an exponent with no digits.  When
+ *  there is no number at all they return 0 (or false) and set *end to s,
+ *  so a caller that needs to know must check end.  decimalParse() with
+ *  strict set accepts only JSON's number grammar and treats anything else
+ *  as no number.
+ */
+
+#ifndef DECIMALCODEC_H
+#define DECIMALCODEC_H
+
+#include "Arduino.h"
+
+#define DECIMAL_BUFFER_SIZE 24 /**< Room decimalFormat() may need */
+#define DECIMAL_DECIMALS_MAX 9 /**< Most fraction digits formatted */
+
+double decimalParse(const char *s, const char **end = NULL,
+                    bool strict = false);
+bool decimalParseFixed(const char *s, uint8_t decimals, int32_t &value,
+                       const char **end = NULL);
+size_t decimalFormat(char *buffer, double value, uint8_t decimals);
+size_t decimalFormatFixed(char *buffer, int32_t value, uint8_t decimals);
+size_t decimalPrint(Print &out, double value, uint8_t decimals);
+
+#endif
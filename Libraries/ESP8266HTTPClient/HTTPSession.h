@@ -0,0 +1,93 @@
+/**
+ * HTTPSession.h
+ *
+ * A keep-alive session for polling one URL: the HTTP client is set up once
+ * and its TCP connection kept open between requests, so a poll normally
+ * skips DNS and the TCP handshake.  When the server has closed an idle
+ * connection the request goes out again on a new one.
+ *
+ *   WiFiClient client;
+ *   HTTPClient http;
+ *   HTTPSession<HTTPClient, WiFiClient> session(http, client);
+ *
+ *   session.begin(url);                // once
+ *   int code = session.GET(&decoder);  // every poll; the body goes to decoder
+ *
+ * HTTP and Client are template parameters so that the session can be run
+ * against a stand-in HTTP client off the device.
+ */
+
+#ifndef HTTPSession_H_
+#define HTTPSession_H_
+
+#include <Arduino.h>
+
+template <class HTTP, class Client>
+class HTTPSession
+{
+public:
+    HTTPSession(HTTP& http, Client& client) :
+        _http(http),
+        _client(client),
+        _ready(false),
+        _connections(0),
+        _latency(0)
+    {
+    }
+
+    // Set up the client for url (built once by the caller) with keep-alive on.
+    bool begin(const String& url)
+    {
+        _ready = _http.begin(_client, url);
+        if (_ready) {
+            _http.setReuse(true);
+        }
+        return _ready;
+    }
+
+    bool ready() const { return _ready; }
+
+    // Send the GET request and, if the server answered, write the whole body
+    // to body, which leaves the connection ready for the next request.
+    // Returns the HTTP status code, or a negative HTTPC_ERROR_* code.
+    template <typename S>
+    int GET(S* body)
+    {
+        unsigned long start = millis();
+        bool reused = _http.connected();
+
+        if (!reused) {
+            _connections++;
+        }
+        int code = _http.GET();
+
+        // the server may drop an idle connection just as it is reused; the
+        // failed request closed it, so try once more on a new one
+        if (code < 0 && reused) {
+            _connections++;
+            code = _http.GET();
+        }
+
+        if (code > 0) {
+            _http.writeToStream(body);
+        }
+
+        _latency = millis() - start;
+        return code;
+    }
+
+    // TCP connections opened (or attempted) so far
+    unsigned long connections() const { return _connections; }
+
+    // ms the last GET() took, body included
+    unsigned long latency() const { return _latency; }
+
+private:
+    HTTP& _http;
+    Client& _client;
+    bool _ready;
+    unsigned long _connections;
+    unsigned long _latency;
+};
+
+#endif /* HTTPSession_H_ */
@@ -5,6 +5,35 @@
 #include <inttypes.h>
 #include "Arduino.h"
 
+#ifdef __AVR
+// Write a single pin through its output register.  Interrupts are held off
+// for the read-modify-write, as ports above 0x3F (e.g. PORTH/PORTL on the
+// Mega) are not bit-addressable and an ISR could touch the same port.
+static inline void fastWrite(volatile uint8_t *out, uint8_t bit, uint8_t value)
+{
+  uint8_t oldSREG = SREG;
+  cli();
+  if (value) {
+    *out |= bit;
+  } else {
+    *out &= ~bit;
+  }
+  SREG = oldSREG;
+}
+
+#define LCD_WRITE(pin, value) fastWrite(_##pin##_out, _##pin##_bit, value)
+#else
+#define LCD_WRITE(pin, value) digitalWrite(_##pin##_pin, value)
+#endif
+
+// clear and home take ~1.5 ms, everything else ~37 us
+static inline bool isLongCommand(uint8_t value, uint8_t mode)
+{
+  return mode == LOW && (value == LCD_CLEARDISPLAY || (value & ~1) == LCD_RETURNHOME);
+}
+
+LiquidCrystal *LiquidCrystal::_async_head = NULL;
+
 // When the display powers up, it is configured as follows:
 //
 // 1. Display clear
@@ -50,10 +79,32 @@ LiquidCrystal::LiquidCrystal(uint8_t rs,  uint8_t enable,
   init(1, rs, 255, enable, d0, d1, d2, d3, 0, 0, 0, 0);
 }
 
+// Display behind a LiquidCrystalTransport.  Nothing is sent until begin(),
+// so the transport's bus (e.g. Wire) can be set up in setup() first.
+LiquidCrystal::LiquidCrystal(LiquidCrystalTransport &transport)
+{
+  _transport = &transport;
+  _batch = 0;
+  _rs_pin = 255;
+  _rw_pin = 255;
+  _enable_pin = 255;
+
+  _busy_poll = 0;
+  _bus_us = 0;
+  _q_buf = NULL;
+  _q_irq = 0;
+
+  _displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
+  _numlines = 1;
+  setRowOffsets(0x00, 0x40, 0x10, 0x50);
+}
+
 void LiquidCrystal::init(uint8_t fourbitmode, uint8_t rs, uint8_t rw, uint8_t enable,
 			 uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3,
 			 uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
 {
+  _transport = NULL;
+  _batch = 0;
   _rs_pin = rs;
   _rw_pin = rw;
   _enable_pin = enable;
@@ -67,6 +118,38 @@ void LiquidCrystal::init(uint8_t fourbitmode, uint8_t rs, uint8_t rw, uint8_t en
   _data_pins[6] = d6;
   _data_pins[7] = d7; 
 
+#ifdef __AVR
+  // Resolve the pins to port registers once, instead of doing the
+  // digitalWrite() table lookups every time a nibble is clocked out.
+  _rs_out = portOutputRegister(digitalPinToPort(rs));
+  _rs_bit = digitalPinToBitMask(rs);
+  _enable_out = portOutputRegister(digitalPinToPort(enable));
+  _enable_bit = digitalPinToBitMask(enable);
+  if (rw != 255) {
+    _rw_out = portOutputRegister(digitalPinToPort(rw));
+    _rw_bit = digitalPinToBitMask(rw);
+  }
+
+  uint8_t buswidth = fourbitmode ? 4 : 8;
+  _bus_out = portOutputRegister(digitalPinToPort(d0));
+  _bus_mask = 0;
+  for (int i = 0; i < buswidth; ++i) {
+    _data_out[i] = portOutputRegister(digitalPinToPort(_data_pins[i]));
+    _data_bit[i] = digitalPinToBitMask(_data_pins[i]);
+    _bus_mask |= _data_bit[i];
+    if (_data_out[i] != _bus_out) {
+      _bus_out = NULL;
+    }
+  }
+  _busy_in = portInputRegister(digitalPinToPort(_data_pins[buswidth - 1]));
+  _busy_bit = _data_bit[buswidth - 1];
+#endif
+
+  _busy_poll = 0;
+  _bus_us = 0;
+  _q_buf = NULL;
+  _q_irq = 0;
+
   if (fourbitmode)
     _displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
   else 
@@ -76,6 +159,15 @@ void LiquidCrystal::init(uint8_t fourbitmode, uint8_t rs, uint8_t rw, uint8_t en
 }
 
 void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
+  // the busy flag can't be checked until the function set is done,
+  // so run the whole initialization on the datasheet delays
+  uint8_t busypoll = _busy_poll;
+  _busy_poll = 0;
+  // the start of the sequence below bypasses the queue
+  if (_q_buf != NULL) {
+    flushAsync();
+  }
+
   if (lines > 1) {
     _displayfunction |= LCD_2LINE;
   }
@@ -88,28 +180,37 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
     _displayfunction |= LCD_5x10DOTS;
   }
 
-  pinMode(_rs_pin, OUTPUT);
-  // we can save 1 pin by not using RW. Indicate by passing 255 instead of pin#
-  if (_rw_pin != 255) { 
-    pinMode(_rw_pin, OUTPUT);
+  if (_transport != NULL) {
+    _transport->begin();
+  } else {
+    pinMode(_rs_pin, OUTPUT);
+    // we can save 1 pin by not using RW. Indicate by passing 255 instead of pin#
+    if (_rw_pin != 255) { 
+      pinMode(_rw_pin, OUTPUT);
+    }
+    pinMode(_enable_pin, OUTPUT);
+    
+    // Do these once, instead of every time a character is drawn for speed reasons.
+    for (int i=0; i<((_displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
+    {
+      pinMode(_data_pins[i], OUTPUT);
+      // digitalWrite also detaches any PWM timer from the pin, which the
+      // direct port writes below would otherwise not override.
+      digitalWrite(_data_pins[i], LOW);
+    }
   }
-  pinMode(_enable_pin, OUTPUT);
-  
-  // Do these once, instead of every time a character is drawn for speed reasons.
-  for (int i=0; i<((_displayfunction & LCD_8BITMODE) ? 8 : 4); ++i)
-  {
-    pinMode(_data_pins[i], OUTPUT);
-   } 
 
   // SEE PAGE 45/46 FOR INITIALIZATION SPECIFICATION!
   // according to datasheet, we need at least 40 ms after power rises above 2.7 V
   // before sending commands. Arduino can turn on way before 4.5 V so we'll wait 50
   delayMicroseconds(50000); 
   // Now we pull both RS and R/W low to begin commands
-  digitalWrite(_rs_pin, LOW);
-  digitalWrite(_enable_pin, LOW);
-  if (_rw_pin != 255) { 
-    digitalWrite(_rw_pin, LOW);
+  if (_transport == NULL) {
+    digitalWrite(_rs_pin, LOW);
+    digitalWrite(_enable_pin, LOW);
+    if (_rw_pin != 255) { 
+      digitalWrite(_rw_pin, LOW);
+    }
   }
   
   //put the LCD into 4 bit or 8 bit mode
@@ -162,6 +263,7 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
   // set the entry mode
   command(LCD_ENTRYMODESET | _displaymode);
 
+  _busy_poll = busypoll;
 }
 
 void LiquidCrystal::setRowOffsets(int row0, int row1, int row2, int row3)
@@ -172,17 +274,172 @@ void LiquidCrystal::setRowOffsets(int row0, int row1, int row2, int row3)
   _row_offsets[3] = row3;
 }
 
+// With an RW pin wired, read the busy flag before every transfer instead
+// of waiting the worst-case execution time after it.  Without RW this is
+// a no-op and the fixed delays stay in use.
+void LiquidCrystal::setBusyPolling(bool enable)
+{
+  _busy_poll = enable && (_rw_pin != 255);
+}
+
+/*********** asynchronous output */
+
+// Queue write()/command() into buffer and let a timer interrupt clock the
+// bytes out at the controller's pace, so printing never waits for the bus.
+// The buffer must outlive the asynchronous mode.  On AVR Timer2 is taken
+// over (no analogWrite on its pins, no tone()); elsewhere asyncTick() has
+// to be called every LCD_ASYNC_TICK_US from a timer interrupt of the
+// sketch's own.
+bool LiquidCrystal::beginAsync(uint16_t *buffer, uint8_t size)
+{
+  // a transport's bus can't be driven from inside the timer interrupt
+  if (_transport != NULL) {
+    return false;
+  }
+  return attachQueue(buffer, size, true);
+}
+
+// Shared by beginAsync() and LiquidCrystalGroup::add(); with irq false the
+// queue is only drained by whoever calls serviceQueue().
+bool LiquidCrystal::attachQueue(uint16_t *buffer, uint8_t size, bool irq)
+{
+  if (buffer == NULL || size < 2) {
+    return false;
+  }
+  if (_q_buf != NULL) {
+    endAsync();
+  }
+
+  _q_size = size;
+  _q_head = _q_tail = 0;
+  _q_high = 0;
+  _q_stalls = 0;
+  _q_ready_at = micros();
+  _q_phase = 0;
+  _q_wait = 0;
+  _q_irq = irq;
+
+  if (!irq) {
+    _q_buf = buffer;
+    return true;
+  }
+
+#ifdef __AVR
+  uint8_t oldSREG = SREG;
+  cli();
+  if (_async_head == NULL) {
+    // CTC mode, clk/32, one compare match every LCD_ASYNC_TICK_US
+    TCCR2A = _BV(WGM21);
+    TCCR2B = _BV(CS21) | _BV(CS20);
+    OCR2A = (F_CPU / 1000000UL * LCD_ASYNC_TICK_US) / 32 - 1;
+    TCNT2 = 0;
+  }
+  _q_buf = buffer;
+  _async_next = _async_head;
+  _async_head = this;
+  SREG = oldSREG;
+#else
+  noInterrupts();
+  _q_buf = buffer;
+  _async_next = _async_head;
+  _async_head = this;
+  interrupts();
+#endif
+  return true;
+}
+
+// Drain the queue and go back to synchronous writes.
+void LiquidCrystal::endAsync()
+{
+  if (_q_buf == NULL) {
+    return;
+  }
+  flushAsync();
+
+  if (!_q_irq) {
+    _q_buf = NULL;
+    return;
+  }
+
+#ifdef __AVR
+  uint8_t oldSREG = SREG;
+  cli();
+#else
+  noInterrupts();
+#endif
+  for (LiquidCrystal **p = &_async_head; *p != NULL; p = &(*p)->_async_next) {
+    if (*p == this) {
+      *p = _async_next;
+      break;
+    }
+  }
+  _q_buf = NULL;
+  _q_irq = 0;
+#ifdef __AVR
+  SREG = oldSREG;
+#else
+  interrupts();
+#endif
+}
+
+// Block until everything queued so far has reached the display.
+void LiquidCrystal::flushAsync()
+{
+  while (!idle()) {
+    if (!_q_irq) {
+      serviceQueue(micros());
+    }
+  }
+}
+
+// True when the queue is empty and the last byte has finished executing.
+bool LiquidCrystal::idle()
+{
+  if (_q_buf == NULL) {
+    return true;
+  }
+  if (_q_head != _q_tail) {
+    return false;
+  }
+  if (_q_irq) {
+    return _q_phase == 0 && _q_wait == 0;
+  }
+#ifdef __AVR
+  uint8_t oldSREG = SREG;
+  cli();
+  unsigned long ready = _q_ready_at;
+  SREG = oldSREG;
+#else
+  unsigned long ready = _q_ready_at;
+#endif
+  return (long)(micros() - ready) >= 0;
+}
+
+uint8_t LiquidCrystal::queueDepth()
+{
+  if (_q_buf == NULL) {
+    return 0;
+  }
+  uint8_t head = _q_head;
+  uint8_t tail = _q_tail;
+  return head >= tail ? head - tail : _q_size - tail + head;
+}
+
 /********** high level commands, for the user! */
 void LiquidCrystal::clear()
 {
   command(LCD_CLEARDISPLAY);  // clear display, set cursor position to zero
-  delayMicroseconds(2000);  // this command takes a long time!
+  if (!_busy_poll && _q_buf == NULL) {
+    delayMicroseconds(2000);  // this command takes a long time!
+  }
 }
 
 void LiquidCrystal::home()
 {
   command(LCD_RETURNHOME);  // set cursor position to zero
-  delayMicroseconds(2000);  // this command takes a long time!
+  if (!_busy_poll && _q_buf == NULL) {
+    delayMicroseconds(2000);  // this command takes a long time!
+  }
 }
 
 void LiquidCrystal::setCursor(uint8_t col, uint8_t row)
@@ -281,46 +538,291 @@ inline size_t LiquidCrystal::write(uint8_t value) {
   return 1; // assume success
 }
 
+// Strings go out as one batch, so a transport can pack all their nibbles
+// into as few bus transactions as its buffer allows.
+size_t LiquidCrystal::write(const uint8_t *buffer, size_t size) {
+  _batch = 1;
+  for (size_t i = 0; i < size; i++) {
+    send(buffer[i], HIGH);
+  }
+  _batch = 0;
+  if (_transport != NULL) {
+    _transport->flush();
+  }
+  return size;
+}
+
 /************ low level data pushing commands **********/
 
 // write either command or data, with automatic 4/8-bit selection
 void LiquidCrystal::send(uint8_t value, uint8_t mode) {
-  digitalWrite(_rs_pin, mode);
+  _bus_us += isLongCommand(value, mode) ? LCD_ASYNC_LONG_US : LCD_ASYNC_SETTLE_US;
+
+  if (_q_buf != NULL) {
+    enqueue(value | (mode ? LCD_QUEUE_RS : 0));
+    return;
+  }
+
+  if (_busy_poll) {
+    waitReady();
+  }
+
+  transfer(value, mode);
+
+  // a transport's own bus time covers the settle time
+  if (!_busy_poll && _transport == NULL) {
+    delayMicroseconds(100);   // commands need >37 us to settle
+  }
+}
+
+// put one byte on the bus, without waiting for it to execute
+void LiquidCrystal::transfer(uint8_t value, uint8_t mode) {
+  if (_transport != NULL) {
+    _transport->write4bits(value>>4, mode);
+    _transport->write4bits(value, mode);
+    if (!_batch) {
+      _transport->flush();
+    }
+    return;
+  }
+
+  LCD_WRITE(rs, mode);
 
   // if there is a RW pin indicated, set it low to Write
   if (_rw_pin != 255) { 
-    digitalWrite(_rw_pin, LOW);
+    LCD_WRITE(rw, LOW);
   }
   
   if (_displayfunction & LCD_8BITMODE) {
-    write8bits(value); 
+    writeDataBits(value, 8);
+    pulseEnable();
   } else {
-    write4bits(value>>4);
-    write4bits(value);
+    writeDataBits(value>>4, 4);
+    pulseEnable();
+    writeDataBits(value, 4);
+    pulseEnable();
   }
 }
 
+void LiquidCrystal::enqueue(uint16_t entry) {
+  uint8_t next = _q_head + 1;
+  if (next == _q_size) {
+    next = 0;
+  }
+  if (next == _q_tail) {
+    // full: wait for the interrupt (or drain it ourselves) to make room
+    _q_stalls++;
+    while (next == _q_tail) {
+      if (!_q_irq) {
+        serviceQueue(micros());
+      }
+    }
+  }
+  _q_buf[_q_head] = entry;
+  _q_head = next;
+
+  uint8_t depth = queueDepth();
+  if (depth > _q_high) {
+    _q_high = depth;
+  }
+
+#ifdef __AVR
+  if (_q_irq) {
+    uint8_t oldSREG = SREG;
+    cli();
+    TIMSK2 |= _BV(OCIE2A);
+    SREG = oldSREG;
+  }
+#endif
+}
+
+// Send the next queued byte if the controller is done with the previous one.
+void LiquidCrystal::serviceQueue(unsigned long now) {
+  if (_q_buf == NULL || _q_head == _q_tail || (long)(now - _q_ready_at) < 0) {
+    return;
+  }
+
+  uint16_t entry = _q_buf[_q_tail];
+  uint8_t value = entry & 0xFF;
+  uint8_t mode = (entry & LCD_QUEUE_RS) ? HIGH : LOW;
+  transfer(value, mode);
+
+  uint8_t next = _q_tail + 1;
+  _q_tail = next == _q_size ? 0 : next;
+
+  if (isLongCommand(value, mode)) {
+    _q_ready_at = now + LCD_ASYNC_LONG_US;
+  } else {
+    _q_ready_at = now + LCD_ASYNC_SETTLE_US;
+  }
+}
+
+// One step of an interrupt-driven transfer.  A tick never waits: it either
+// puts a nibble on the bus and raises enable, or lowers enable -- which
+// latches that nibble -- and raises it again with the next one.  The tick
+// between edges is the enable pulse.  After a byte the interrupt idles
+// LCD_ASYNC_SETTLE_TICKS - 1 ticks and spends one more putting out the
+// next byte, so even if the tick that latched the byte ran late the
+// controller gets LCD_ASYNC_SETTLE_US.  Returns true while there is work
+// left.
+bool LiquidCrystal::tickQueue() {
+  if (_q_wait) {
+    _q_wait--;
+    return true;
+  }
+
+  bool eight = _displayfunction & LCD_8BITMODE;
+
+  if (_q_phase != 0) {
+    uint16_t entry = _q_buf[_q_tail];
+    uint8_t value = entry & 0xFF;
+
+    LCD_WRITE(enable, LOW);
+
+    if (_q_phase == 1) {
+      // high nibble latched, now the low one
+      writeDataBits(value, 4);
+      LCD_WRITE(enable, HIGH);
+      _q_phase = 2;
+      return true;
+    }
+
+    uint8_t next = _q_tail + 1;
+    _q_tail = next == _q_size ? 0 : next;
+    _q_phase = 0;
+
+    if (isLongCommand(value, (entry & LCD_QUEUE_RS) ? HIGH : LOW)) {
+      _q_wait = LCD_ASYNC_LONG_TICKS;
+    } else {
+      _q_wait = LCD_ASYNC_SETTLE_TICKS - 1;
+    }
+    return true;
+  }
+
+  if (_q_head == _q_tail) {
+    return false;
+  }
+
+  uint16_t entry = _q_buf[_q_tail];
+  uint8_t value = entry & 0xFF;
+
+  LCD_WRITE(rs, (entry & LCD_QUEUE_RS) ? HIGH : LOW);
+  if (_rw_pin != 255) {
+    LCD_WRITE(rw, LOW);
+  }
+  writeDataBits(eight ? value : value >> 4, eight ? 8 : 4);
+  LCD_WRITE(enable, HIGH);
+  _q_phase = eight ? 2 : 1;
+  return true;
+}
+
+void LiquidCrystal::asyncTick() {
+  bool pending = false;
+
+  for (LiquidCrystal *lcd = _async_head; lcd != NULL; lcd = lcd->_async_next) {
+    if (lcd->tickQueue()) {
+      pending = true;
+    }
+  }
+
+#ifdef __AVR
+  // nothing left to send: stop ticking until the next enqueue()
+  if (!pending) {
+    TIMSK2 &= ~_BV(OCIE2A);
+  }
+#else
+  (void)pending;
+#endif
+}
+
+#ifdef __AVR
+ISR(TIMER2_COMPA_vect)
+{
+  LiquidCrystal::asyncTick();
+}
+#endif
+
 void LiquidCrystal::pulseEnable(void) {
-  digitalWrite(_enable_pin, LOW);
+  LCD_WRITE(enable, LOW);
   delayMicroseconds(1);    
-  digitalWrite(_enable_pin, HIGH);
+  LCD_WRITE(enable, HIGH);
   delayMicroseconds(1);    // enable pulse must be >450 ns
-  digitalWrite(_enable_pin, LOW);
-  delayMicroseconds(100);   // commands need >37 us to settle
+  LCD_WRITE(enable, LOW);
 }
 
-void LiquidCrystal::write4bits(uint8_t value) {
-  for (int i = 0; i < 4; i++) {
-    digitalWrite(_data_pins[i], (value >> i) & 0x01);
+// Poll the busy flag (DB7) until the controller is ready for the next
+// transfer, giving up after LCD_BUSY_TIMEOUT microseconds.
+void LiquidCrystal::waitReady() {
+  uint8_t buswidth = (_displayfunction & LCD_8BITMODE) ? 8 : 4;
+  for (int i = 0; i < buswidth; i++) {
+    pinMode(_data_pins[i], INPUT);
+  }
+  LCD_WRITE(rs, LOW);
+  LCD_WRITE(rw, HIGH);
+
+  unsigned long start = micros();
+  uint8_t busy;
+  do {
+    LCD_WRITE(enable, HIGH);
+    delayMicroseconds(1);    // data is valid <360 ns after enable rises
+#ifdef __AVR
+    busy = *_busy_in & _busy_bit;
+#else
+    busy = digitalRead(_data_pins[buswidth - 1]);
+#endif
+    LCD_WRITE(enable, LOW);
+    delayMicroseconds(1);
+
+    if (buswidth == 4) {
+      // the address counter nibble has to be clocked out as well
+      LCD_WRITE(enable, HIGH);
+      delayMicroseconds(1);
+      LCD_WRITE(enable, LOW);
+      delayMicroseconds(1);
+    }
+  } while (busy && (micros() - start) < LCD_BUSY_TIMEOUT);
+
+  LCD_WRITE(rw, LOW);
+  for (int i = 0; i < buswidth; i++) {
+    pinMode(_data_pins[i], OUTPUT);
   }
-
-  pulseEnable();
 }
 
-void LiquidCrystal::write8bits(uint8_t value) {
-  for (int i = 0; i < 8; i++) {
+// put the low `count` bits of value on the data pins
+void LiquidCrystal::writeDataBits(uint8_t value, uint8_t count) {
+#ifdef __AVR
+  if (_bus_out != NULL) {
+    uint8_t bits = 0;
+    for (int i = 0; i < count; i++) {
+      if ((value >> i) & 0x01) {
+        bits |= _data_bit[i];
+      }
+    }
+
+    uint8_t oldSREG = SREG;
+    cli();
+    *_bus_out = (*_bus_out & ~_bus_mask) | bits;
+    SREG = oldSREG;
+    return;
+  }
+
+  for (int i = 0; i < count; i++) {
+    fastWrite(_data_out[i], _data_bit[i], (value >> i) & 0x01);
+  }
+#else
+  for (int i = 0; i < count; i++) {
     digitalWrite(_data_pins[i], (value >> i) & 0x01);
   }
-  
-  pulseEnable();
+#endif
+}
+
+void LiquidCrystal::write4bits(uint8_t value) {
+  if (_transport != NULL) {
+    _transport->write4bits(value, LOW);
+    _transport->flush();
+  } else {
+    writeDataBits(value, 4);
+    pulseEnable();
+  }
+  delayMicroseconds(100);   // commands need >37 us to settle
 }
@@ -42,6 +42,32 @@
 #define LCD_5x10DOTS 0x04
 #define LCD_5x8DOTS 0x00
 
+// longest we poll the busy flag before giving up (clear/home need ~1.5 ms)
+#define LCD_BUSY_TIMEOUT 3000
+
+// asynchronous mode: timer tick and per-command execution times (in us).
+// A command takes 37 us at 270 kHz but ~53 us at the slowest rated clock.
+#define LCD_ASYNC_TICK_US 40
+#define LCD_ASYNC_SETTLE_US 80
+#define LCD_ASYNC_LONG_US 2000
+// ticks the interrupt idles after a byte, and after clear/home
+#define LCD_ASYNC_SETTLE_TICKS ((LCD_ASYNC_SETTLE_US + LCD_ASYNC_TICK_US - 1) / LCD_ASYNC_TICK_US)
+#define LCD_ASYNC_LONG_TICKS ((LCD_ASYNC_LONG_US + LCD_ASYNC_TICK_US - 1) / LCD_ASYNC_TICK_US)
+#define LCD_QUEUE_RS 0x100 // queue entry flag: RS high (character data)
+
+// A bus other than the Arduino's own pins that the display is wired to,
+// e.g. an I2C port expander backpack.  It always runs the display in 4-bit
+// mode with RW tied low.  write4bits() may buffer; flush() has to push
+// everything buffered out before it returns.  The transfers must be slow
+// enough on their own that the controller keeps up (>37 us per byte) --
+// LiquidCrystal only waits after clear() and home().
+class LiquidCrystalTransport {
+public:
+  virtual void begin() = 0;
+  virtual void write4bits(uint8_t value, uint8_t mode) = 0;
+  virtual void flush() = 0;
+};
+
 class LiquidCrystal : public Print {
 public:
   LiquidCrystal(uint8_t rs, uint8_t enable,
@@ -54,6 +80,7 @@ public:
 		uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
   LiquidCrystal(uint8_t rs, uint8_t enable,
 		uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3);
+  LiquidCrystal(LiquidCrystalTransport &transport);
 
   void init(uint8_t fourbitmode, uint8_t rs, uint8_t rw, uint8_t enable,
 	    uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3,
@@ -77,32 +104,94 @@ public:
   void autoscroll();
   void noAutoscroll();
 
+  void setBusyPolling(bool);
+
+  bool beginAsync(uint16_t *buffer, uint8_t size);
+  void endAsync();
+  void flushAsync();
+  bool idle();
+  uint8_t queueDepth();
+  uint8_t queueHighWater() { return _q_high; }
+  uint16_t queueStalls() { return _q_stalls; }
+  static void asyncTick(); // called from the timer interrupt
+
+  // estimated controller time (us) of everything sent so far
+  unsigned long busTime() { return _bus_us; }
+
+  friend class LiquidCrystalGroup;
+
   void setRowOffsets(int row1, int row2, int row3, int row4);
   void createChar(uint8_t, uint8_t[]);
   void setCursor(uint8_t, uint8_t); 
   virtual size_t write(uint8_t);
+  virtual size_t write(const uint8_t *, size_t);
   void command(uint8_t);
   
   using Print::write;
 private:
   void send(uint8_t, uint8_t);
+  void transfer(uint8_t, uint8_t);
+  bool attachQueue(uint16_t *, uint8_t, bool);
+  void enqueue(uint16_t);
+  void serviceQueue(unsigned long);
+  bool tickQueue();
   void write4bits(uint8_t);
-  void write8bits(uint8_t);
+  void writeDataBits(uint8_t, uint8_t);
   void pulseEnable();
+  void waitReady();
 
   uint8_t _rs_pin; // LOW: command. HIGH: character.
   uint8_t _rw_pin; // LOW: write to LCD. HIGH: read from LCD.
   uint8_t _enable_pin; // activated by a HIGH pulse.
   uint8_t _data_pins[8];
 
+  // NULL when the display is on the pins above
+  LiquidCrystalTransport *_transport;
+  uint8_t _batch; // inside write(buffer, size): leave the transport buffered
+
+#ifdef __AVR
+  // Use direct GPIO access on an 8-bit AVR so keep track of the output
+  // register and bitmask for every pin.  Other platforms use digitalWrite.
+  volatile uint8_t *_rs_out, *_rw_out, *_enable_out;
+  uint8_t _rs_bit, _rw_bit, _enable_bit;
+  volatile uint8_t *_data_out[8];
+  uint8_t _data_bit[8];
+  // When all data pins live on one port a whole nibble/byte is written with
+  // a single masked read-modify-write; _bus_out is NULL otherwise.
+  volatile uint8_t *_bus_out;
+  uint8_t _bus_mask;
+  // input register and bitmask of DB7, for reading the busy flag
+  volatile uint8_t *_busy_in;
+  uint8_t _busy_bit;
+#endif
+
   uint8_t _displayfunction;
   uint8_t _displaycontrol;
   uint8_t _displaymode;
 
   uint8_t _initialized;
+  uint8_t _busy_poll; // poll the busy flag instead of fixed delays
+  unsigned long _bus_us;
 
   uint8_t _numlines;
   uint8_t _row_offsets[4];
+
+  // Asynchronous mode: write()/command() push into a caller-supplied ring
+  // that the timer interrupt (or a LiquidCrystalGroup, when _q_irq is 0)
+  // drains.  _q_buf is NULL in synchronous mode.
+  uint16_t *_q_buf;
+  uint8_t _q_size;
+  uint8_t _q_irq;
+  volatile uint8_t _q_head, _q_tail;
+  uint8_t _q_high;
+  uint16_t _q_stalls;
+  unsigned long _q_ready_at; // micros() when the controller is free again
+  // Interrupt side: where the byte at _q_tail is in its transfer, and ticks
+  // left before the controller takes the next one.
+  volatile uint8_t _q_phase;
+  volatile uint8_t _q_wait;
+  LiquidCrystal *_async_next;
+  static LiquidCrystal *_async_head;
 };
 
 #endif
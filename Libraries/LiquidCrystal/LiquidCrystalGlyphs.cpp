@@ -0,0 +1,211 @@
+#include "LiquidCrystalGlyphs.h"
+
+#include <string.h>
+#include "Arduino.h"
+
+LiquidCrystalGlyphs::LiquidCrystalGlyphs(LiquidCrystal &lcd) : _lcd(lcd)
+{
+  reset();
+}
+
+// Forget everything, e.g. after the display was power cycled.
+void LiquidCrystalGlyphs::reset()
+{
+  for (uint8_t i = 0; i < LCD_GLYPH_SLOTS; i++) {
+    _refs[i] = 0;
+    _order[i] = i;
+  }
+  _valid = 0;
+  _uploads = 0;
+}
+
+void LiquidCrystalGlyphs::touch(uint8_t slot)
+{
+  uint8_t i = 0;
+  while (_order[i] != slot) {
+    i++;
+  }
+  for (; i > 0; i--) {
+    _order[i] = _order[i - 1];
+  }
+  _order[0] = slot;
+}
+
+// Return the character code (0-7) showing bitmap, uploading it into the
+// least recently used free slot if needed.  Returns LCD_NO_GLYPH when all
+// 8 slots are on screen.
+uint8_t LiquidCrystalGlyphs::acquire(const uint8_t bitmap[8])
+{
+  for (uint8_t slot = 0; slot < LCD_GLYPH_SLOTS; slot++) {
+    if ((_valid & (1 << slot)) && memcmp(_bitmaps[slot], bitmap, 8) == 0) {
+      _refs[slot]++;
+      touch(slot);
+      return slot;
+    }
+  }
+
+  for (int8_t i = LCD_GLYPH_SLOTS - 1; i >= 0; i--) {
+    uint8_t slot = _order[i];
+    if (_refs[slot] == 0) {
+      memcpy(_bitmaps[slot], bitmap, 8);
+      _lcd.createChar(slot, _bitmaps[slot]);
+      _valid |= 1 << slot;
+      _uploads++;
+      _refs[slot] = 1;
+      touch(slot);
+      return slot;
+    }
+  }
+
+  return LCD_NO_GLYPH;
+}
+
+void LiquidCrystalGlyphs::release(uint8_t code)
+{
+  if (code < LCD_GLYPH_SLOTS && _refs[code] > 0) {
+    _refs[code]--;
+  }
+}
+
+/********** bar graph */
+
+LiquidCrystalBar::LiquidCrystalBar(LiquidCrystal &lcd, LiquidCrystalGlyphs &glyphs,
+                                   uint8_t col, uint8_t row, uint8_t width)
+  : _lcd(lcd), _glyphs(glyphs), _col(col), _row(row), _width(width)
+{
+  _glyph = LCD_NO_GLYPH;
+  _level = -1;
+}
+
+// Call after the cells were overwritten (e.g. by clear()) to redraw all.
+void LiquidCrystalBar::invalidate()
+{
+  _glyphs.release(_glyph);
+  _glyph = LCD_NO_GLYPH;
+  _level = -1;
+}
+
+void LiquidCrystalBar::draw(long value, long max)
+{
+  int levels = _width * 5;
+  int level = 0;
+  if (max > 0 && value > 0) {
+    level = value >= max ? levels : (int)((value * levels) / max);
+  }
+  if (level == _level) {
+    return;
+  }
+
+  // only the cells between the old and the new level change
+  uint8_t first = 0;
+  uint8_t last = _width - 1;
+  if (_level >= 0) {
+    int lo = level < _level ? level : _level;
+    int hi = level < _level ? _level : level;
+    first = lo / 5;
+    last = (hi - 1) / 5;
+  }
+
+  uint8_t partial = level % 5;
+  uint8_t glyph = LCD_NO_GLYPH;
+  if (partial != 0) {
+    uint8_t bitmap[8];
+    memset(bitmap, (0x1F << (5 - partial)) & 0x1F, sizeof(bitmap));
+    glyph = _glyphs.acquire(bitmap);
+  }
+
+  _lcd.setCursor(_col + first, _row);
+  for (uint8_t cell = first; cell <= last; cell++) {
+    int lit = level - cell * 5;
+    if (lit >= 5) {
+      _lcd.write(LCD_FULL_BLOCK);
+    } else if (lit <= 0 || glyph == LCD_NO_GLYPH) {
+      _lcd.write(' ');
+    } else {
+      _lcd.write(glyph);
+    }
+  }
+
+  _glyphs.release(_glyph);
+  _glyph = glyph;
+  _level = level;
+}
+
+/********** sparkline */
+
+LiquidCrystalSparkline::LiquidCrystalSparkline(LiquidCrystal &lcd, LiquidCrystalGlyphs &glyphs,
+                                               uint8_t col, uint8_t row, uint8_t width)
+  : _lcd(lcd), _glyphs(glyphs), _col(col), _row(row)
+{
+  _width = width > LCD_SPARK_MAX_CELLS ? LCD_SPARK_MAX_CELLS : width;
+  _count = 0;
+  _next = 0;
+  for (uint8_t i = 0; i < LCD_SPARK_MAX_CELLS; i++) {
+    _codes[i] = LCD_NO_GLYPH;
+  }
+}
+
+void LiquidCrystalSparkline::push(int sample)
+{
+  uint8_t capacity = _width * 5;
+  _samples[_next] = sample;
+  _next = _next + 1 == capacity ? 0 : _next + 1;
+  if (_count < capacity) {
+    _count++;
+  }
+}
+
+void LiquidCrystalSparkline::invalidate()
+{
+  for (uint8_t i = 0; i < _width; i++) {
+    _glyphs.release(_codes[i]);
+    _codes[i] = LCD_NO_GLYPH;
+  }
+}
+
+void LiquidCrystalSparkline::draw()
+{
+  uint8_t capacity = _width * 5;
+  if (_count == 0) {
+    return;
+  }
+
+  // oldest sample first; the newest ends up in the rightmost column
+  uint8_t start = _count < capacity ? 0 : _next;
+  int lo = _samples[start];
+  int hi = lo;
+  for (uint8_t i = 0; i < _count; i++) {
+    int s = _samples[(start + i) % capacity];
+    if (s < lo) lo = s;
+    if (s > hi) hi = s;
+  }
+
+  for (uint8_t cell = 0; cell < _width; cell++) {
+    uint8_t bitmap[8] = { 0 };
+    for (uint8_t x = 0; x < 5; x++) {
+      // columns before the first sample stay empty
+      int index = cell * 5 + x - (capacity - _count);
+      if (index < 0) {
+        continue;
+      }
+      int s = _samples[(start + index) % capacity];
+      uint8_t height = hi == lo ? 4 : 1 + (uint8_t)((long)(s - lo) * 7 / (hi - lo));
+      for (uint8_t y = 8 - height; y < 8; y++) {
+        bitmap[y] |= 0x10 >> x;
+      }
+    }
+
+    uint8_t code = _glyphs.acquire(bitmap);
+    if (code == _codes[cell]) {
+      // unchanged: drop the extra reference acquire() just took
+      _glyphs.release(code);
+      continue;
+    }
+    if (code != LCD_NO_GLYPH) {
+      _lcd.setCursor(_col + cell, _row);
+      _lcd.write(code);
+      _glyphs.release(_codes[cell]);
+      _codes[cell] = code;
+    }
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef LiquidCrystalGlyphs_h
+#define LiquidCrystalGlyphs_h
+
+#include <inttypes.h>
+#include "LiquidCrystal.h"
+
+#define LCD_GLYPH_SLOTS 8
+#define LCD_NO_GLYPH 0xFF
+
+// full block character in the HD44780 A00 character ROM
+#define LCD_FULL_BLOCK 0xFF
+
+// Keeps track of what the 8 CGRAM slots hold, so a custom character is
+// only uploaded (9 bus transfers) when no slot already has that bitmap.
+// acquire() pins a slot while the character is on screen; release() it
+// once the cell is overwritten.  Unpinned slots are kept as a cache and
+// reused least recently used first.
+//
+// An upload leaves the display addressing CGRAM: acquire glyphs first,
+// then setCursor() and write them.
+class LiquidCrystalGlyphs {
+public:
+  LiquidCrystalGlyphs(LiquidCrystal &lcd);
+
+  uint8_t acquire(const uint8_t bitmap[8]);
+  void release(uint8_t code);
+  void reset();
+
+  uint16_t uploads() { return _uploads; }
+
+private:
+  void touch(uint8_t slot);
+
+  LiquidCrystal &_lcd;
+  uint8_t _bitmaps[LCD_GLYPH_SLOTS][8];
+  uint8_t _refs[LCD_GLYPH_SLOTS];
+  uint8_t _order[LCD_GLYPH_SLOTS]; // slots, most recently used first
+  uint8_t _valid;                  // bitmask of slots with known contents
+  uint16_t _uploads;
+};
+
+// Horizontal bar of `width` cells, 5 levels per cell.  Only the cells
+// between the old and the new level are rewritten.
+class LiquidCrystalBar {
+public:
+  LiquidCrystalBar(LiquidCrystal &lcd, LiquidCrystalGlyphs &glyphs,
+                   uint8_t col, uint8_t row, uint8_t width);
+
+  void draw(long value, long max);
+  void invalidate();
+
+private:
+  LiquidCrystal &_lcd;
+  LiquidCrystalGlyphs &_glyphs;
+  uint8_t _col, _row, _width;
+  uint8_t _glyph;  // partial-cell glyph on screen, or LCD_NO_GLYPH
+  int _level;      // columns lit, -1 when unknown
+};
+
+#define LCD_SPARK_MAX_CELLS 4
+
+// Mini line chart of the last width * 5 samples, one pixel column per
+// sample, scaled to the window's own min/max.  Each cell is a custom
+// glyph, so width is limited to LCD_SPARK_MAX_CELLS.
+class LiquidCrystalSparkline {
+public:
+  LiquidCrystalSparkline(LiquidCrystal &lcd, LiquidCrystalGlyphs &glyphs,
+                         uint8_t col, uint8_t row, uint8_t width);
+
+  void push(int sample);
+  void draw();
+  void invalidate();
+
+private:
+  LiquidCrystal &_lcd;
+  LiquidCrystalGlyphs &_glyphs;
+  uint8_t _col, _row, _width;
+  int _samples[LCD_SPARK_MAX_CELLS * 5];
+  uint8_t _count, _next;
+  uint8_t _codes[LCD_SPARK_MAX_CELLS];
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "LiquidCrystalGroup.h"
+
+#include "Arduino.h"
+
+LiquidCrystalGroup::LiquidCrystalGroup()
+{
+  _count = 0;
+}
+
+// Put lcd in the group.  From now on its output is queued in buffer
+// (one entry per byte) until poll() or flush() sends it.  Fails when the
+// group is full, lcd is in it already, or buffer can't hold a queue.
+bool LiquidCrystalGroup::add(LiquidCrystal &lcd, uint16_t *buffer, uint8_t size)
+{
+  // a second entry would poll it twice, and attaching again drops its queue
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_lcds[i] == &lcd) {
+      return false;
+    }
+  }
+  if (_count >= LCD_GROUP_MAX || !lcd.attachQueue(buffer, size, false)) {
+    return false;
+  }
+  _lcds[_count++] = &lcd;
+  return true;
+}
+
+// Send one byte to every panel that is ready for it, round-robin.
+// Returns true once all panels are idle.
+bool LiquidCrystalGroup::poll()
+{
+  bool done = true;
+  for (uint8_t i = 0; i < _count; i++) {
+    _lcds[i]->serviceQueue(micros());
+    if (!_lcds[i]->idle()) {
+      done = false;
+    }
+  }
+  return done;
+}
+
+// Block until everything queued on every panel has been sent.
+void LiquidCrystalGroup::flush()
+{
+  while (!poll()) {
+  }
+}
@@ -0,0 +1,29 @@
+#ifndef LiquidCrystalGroup_h
+#define LiquidCrystalGroup_h
+
+#include <inttypes.h>
+#include "LiquidCrystal.h"
+
+#define LCD_GROUP_MAX 4
+
+// Drives several displays without a timer, interleaving their traffic:
+// while one controller is still executing a byte, the next display's byte
+// goes out, so a refresh of N panels costs about as much bus time as one.
+//
+// Panels may share RS and data lines as long as each has its own enable
+// pin; bytes are never split between panels, and only the panel whose
+// enable is strobed latches the bus.
+class LiquidCrystalGroup {
+public:
+  LiquidCrystalGroup();
+
+  bool add(LiquidCrystal &lcd, uint16_t *buffer, uint8_t size);
+  bool poll();
+  void flush();
+
+private:
+  LiquidCrystal *_lcds[LCD_GROUP_MAX];
+  uint8_t _count;
+};
+
+#endif
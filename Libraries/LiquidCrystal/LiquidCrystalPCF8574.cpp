@@ -0,0 +1,74 @@
+#include "LiquidCrystalPCF8574.h"
+
+#include "Arduino.h"
+
+LiquidCrystalPCF8574::LiquidCrystalPCF8574(uint8_t address, TwoWire &wire)
+  : _wire(wire), _address(address)
+{
+  _backlight = LCD_PCF8574_BACKLIGHT;
+  _port = 0;
+  _len = 0;
+  _transactions = 0;
+}
+
+// Drive every line low (RW stays low from here on).  Wire.begin() must
+// have been called already.
+void LiquidCrystalPCF8574::begin()
+{
+  _len = 0;
+  _port = _backlight;
+  _buf[_len++] = _port;
+  flush();
+}
+
+void LiquidCrystalPCF8574::write4bits(uint8_t value, uint8_t mode)
+{
+  // keep the setup write and both halves of the enable pulse in one
+  // transaction
+  if (_len > LCD_PCF8574_BUFFER - 3) {
+    flush();
+  }
+
+  uint8_t port = (value & 0x0F) << 4 | _backlight;
+  if (mode) {
+    port |= LCD_PCF8574_RS;
+  }
+  // all port pins switch together, so RS and the data lines are set with
+  // enable still low first, to be stable before it rises (tAS)
+  if (port != _port) {
+    _buf[_len++] = port;
+  }
+  _buf[_len++] = port | LCD_PCF8574_EN;   // data latched on the falling edge
+  _buf[_len++] = port;
+  _port = port;
+}
+
+void LiquidCrystalPCF8574::flush()
+{
+  if (_len == 0) {
+    return;
+  }
+  _wire.beginTransmission(_address);
+  _wire.write(_buf, _len);
+  _wire.endTransmission();
+  _len = 0;
+  _transactions++;
+}
+
+void LiquidCrystalPCF8574::backlight()
+{
+  _backlight = LCD_PCF8574_BACKLIGHT;
+  flush();
+  _port = _backlight;
+  _buf[_len++] = _port;
+  flush();
+}
+
+void LiquidCrystalPCF8574::noBacklight()
+{
+  _backlight = 0;
+  flush();
+  _port = _backlight;
+  _buf[_len++] = _port;
+  flush();
+}
@@ -0,0 +1,57 @@
+#ifndef LiquidCrystalPCF8574_h
+#define LiquidCrystalPCF8574_h
+
+#include <inttypes.h>
+#include <Wire.h>
+#include "LiquidCrystal.h"
+
+// bits of the common PCF8574 backpack wiring (P0..P7)
+#define LCD_PCF8574_RS 0x01
+#define LCD_PCF8574_RW 0x02
+#define LCD_PCF8574_EN 0x04
+#define LCD_PCF8574_BACKLIGHT 0x08   // D4..D7 are P4..P7
+
+// bytes per I2C transaction; the AVR Wire library buffers at most 32
+#define LCD_PCF8574_BUFFER 32
+
+// LiquidCrystalTransport for an HD44780 behind a PCF8574 I2C backpack.
+//
+// Every nibble becomes two port writes, enable high then enable low,
+// preceded by a third with enable low when RS or the data lines change, so
+// that they settle before enable rises.  The writes are collected in a
+// buffer that goes out as a single I2C transaction, so a whole string
+// costs one address byte per 32 port writes instead of one transaction
+// per pin change.  At 100 kHz each port write takes ~90 us, which keeps
+// the enable pulses and the per-byte execution time within spec without
+// any delays.
+//
+// Several backpacks with different addresses can share the same two wires.
+//
+//   LiquidCrystalPCF8574 backpack(0x27);
+//   LiquidCrystal lcd(backpack);
+//
+//   void setup() { Wire.begin(); lcd.begin(16, 2); }
+class LiquidCrystalPCF8574 : public LiquidCrystalTransport {
+public:
+  LiquidCrystalPCF8574(uint8_t address, TwoWire &wire = Wire);
+
+  virtual void begin();
+  virtual void write4bits(uint8_t value, uint8_t mode);
+  virtual void flush();
+
+  void backlight();
+  void noBacklight();
+
+  uint16_t transactions() { return _transactions; }
+
+private:
+  TwoWire &_wire;
+  uint8_t _address;
+  uint8_t _backlight;
+  uint8_t _port;       // last value written to the port
+  uint8_t _buf[LCD_PCF8574_BUFFER];
+  uint8_t _len;
+  uint16_t _transactions;
+};
+
+#endif
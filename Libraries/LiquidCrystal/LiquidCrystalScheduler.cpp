@@ -0,0 +1,88 @@
+#include "LiquidCrystalScheduler.h"
+
+#include "Arduino.h"
+
+LiquidCrystalScheduler::LiquidCrystalScheduler(unsigned int budget)
+{
+  _count = 0;
+  _budget = budget;
+}
+
+// Register a display; returns the id to pass to invalidate().  interval
+// is the minimum time between two frames in ms.  The display starts dirty
+// so it gets drawn on the first run().  With LCD_SCHED_MAX displays
+// already registered it returns LCD_SCHED_INVALID, which invalidate() and
+// the counters ignore rather than aliasing another display.
+uint8_t LiquidCrystalScheduler::add(LiquidCrystal &lcd, LiquidCrystalRenderFn render,
+                                    unsigned int interval, uint8_t priority)
+{
+  if (_count >= LCD_SCHED_MAX) {
+    return LCD_SCHED_INVALID;
+  }
+
+  uint8_t id = _count++;
+  Display &d = _displays[id];
+  d.lcd = &lcd;
+  d.render = render;
+  d.interval = interval;
+  d.priority = priority;
+  d.dirty = true;
+  d.deferred = false;
+  d.last = millis() - interval;
+  d.cost = 0;
+  d.frames = d.coalesced = d.dropped = 0;
+
+  // keep _order sorted by priority, stable for equal priorities
+  uint8_t i = id;
+  while (i > 0 && _displays[_order[i - 1]].priority < priority) {
+    _order[i] = _order[i - 1];
+    i--;
+  }
+  _order[i] = id;
+  return id;
+}
+
+void LiquidCrystalScheduler::invalidate(uint8_t id)
+{
+  if (id >= _count) {
+    return;
+  }
+  if (_displays[id].dirty) {
+    _displays[id].coalesced++;
+  }
+  _displays[id].dirty = true;
+}
+
+void LiquidCrystalScheduler::run()
+{
+  unsigned long now = millis();
+  unsigned long spent = 0;
+  bool rendered = false;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    Display &d = _displays[_order[i]];
+    if (!d.dirty || now - d.last < d.interval) {
+      continue;
+    }
+
+    // over budget: leave it dirty for the next pass
+    if (rendered && spent + d.cost > _budget) {
+      if (!d.deferred) {
+        d.dropped++;
+        d.deferred = true;
+      }
+      continue;
+    }
+
+    unsigned long before = d.lcd->busTime();
+    d.dirty = false;
+    d.deferred = false;
+    d.render();
+    d.cost = d.lcd->busTime() - before;
+    d.last = now;
+    d.frames++;
+
+    spent += d.cost;
+    rendered = true;
+  }
+}
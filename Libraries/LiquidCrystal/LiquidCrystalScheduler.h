@@ -0,0 +1,56 @@
+#ifndef LiquidCrystalScheduler_h
+#define LiquidCrystalScheduler_h
+
+#include <inttypes.h>
+#include "LiquidCrystal.h"
+
+#define LCD_SCHED_MAX 4
+#define LCD_SCHED_INVALID 0xFF // add() on a full table; ignored everywhere
+
+typedef void (*LiquidCrystalRenderFn)(void);
+
+// Decides which displays get redrawn on this pass of loop().
+//
+// Each display registers a render function, a minimum interval between
+// frames and a priority.  invalidate() only marks a display dirty, so any
+// number of changes within one frame collapse into a single redraw.  run()
+// then renders the due displays, highest priority first, until the
+// estimated bus time (LiquidCrystal::busTime()) spent this pass exceeds
+// the budget; the rest wait for the next pass.  The first due display is
+// always rendered so a large frame can't starve.
+class LiquidCrystalScheduler {
+public:
+  LiquidCrystalScheduler(unsigned int budget);
+
+  uint8_t add(LiquidCrystal &lcd, LiquidCrystalRenderFn render,
+              unsigned int interval, uint8_t priority);
+  void invalidate(uint8_t id);
+  void run();
+
+  uint16_t frames(uint8_t id) { return id < _count ? _displays[id].frames : 0; }
+  uint16_t coalesced(uint8_t id) { return id < _count ? _displays[id].coalesced : 0; }
+  uint16_t dropped(uint8_t id) { return id < _count ? _displays[id].dropped : 0; }
+
+private:
+  struct Display {
+    LiquidCrystal *lcd;
+    LiquidCrystalRenderFn render;
+    unsigned int interval;   // ms between frames
+    uint8_t priority;
+    bool dirty;
+    bool deferred;           // the pending frame was pushed back already
+    unsigned long last;      // millis() of the last frame
+    unsigned long cost;      // bus time of the last frame, in us
+    uint16_t frames;         // frames rendered
+    uint16_t coalesced;      // invalidations merged into a pending frame
+    uint16_t dropped;        // due frames pushed back by the budget, each
+                             // counted once however many passes it waits
+  };
+
+  Display _displays[LCD_SCHED_MAX];
+  uint8_t _order[LCD_SCHED_MAX]; // ids, highest priority first
+  uint8_t _count;
+  unsigned int _budget;          // us of bus time per run()
+};
+
+#endif
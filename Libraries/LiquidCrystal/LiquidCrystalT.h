@@ -0,0 +1,247 @@
+#ifndef LiquidCrystalT_h
+#define LiquidCrystalT_h
+
+#include <inttypes.h>
+#include "Arduino.h"
+#include "Print.h"
+#include "LiquidCrystal.h"
+
+// LiquidCrystalT<RS, EN, D4, D5, D6, D7> drives a 4-bit display without an
+// RW pin, like LiquidCrystal(rs, enable, d4, d5, d6, d7), but with the pins
+// fixed at compile time.  Pin to port/mask resolution, the bus width and
+// the RW branch all fold away, so every nibble compiles to straight port
+// writes and an instance only keeps the display's shadow state in RAM.
+//
+// The pin tables below cover the Mega 2560 and the Uno/Nano (ATmega328P);
+// other boards fall back to digitalWrite() with constant pin numbers.
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+#define LCD_T_DIRECT
+// port letter and bit for digital pins 0..69
+#define LCD_T_PORTS "EEEEGEHHHHBBBBJJHHDDDDAAAAAAAACCCCCCCCDGGGLLLLLLLLBBBBFFFFFFFFKKKKKKKK"
+#define LCD_T_BITS  "0145533456456710103210012345677654321072107654321032100123456701234567"
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+#define LCD_T_DIRECT
+#define LCD_T_PORTS "DDDDDDDDBBBBBBCCCCCC"
+#define LCD_T_BITS  "01234567012345012345"
+#endif
+
+#ifdef LCD_T_DIRECT
+// data-space address of PORTx for a port letter (DDRx is one below it)
+constexpr uint16_t lcdPortAddress(char port) {
+  return port == 'A' ? 0x22 : port == 'B' ? 0x25 : port == 'C' ? 0x28 :
+         port == 'D' ? 0x2B : port == 'E' ? 0x2E : port == 'F' ? 0x31 :
+         port == 'G' ? 0x34 : port == 'H' ? 0x102 : port == 'J' ? 0x105 :
+         port == 'K' ? 0x108 : port == 'L' ? 0x10B : 0;
+}
+
+constexpr uint16_t lcdPinPort(uint8_t pin) {
+  return lcdPortAddress(LCD_T_PORTS[pin]);
+}
+
+constexpr uint8_t lcdPinMask(uint8_t pin) {
+  return 1 << (LCD_T_BITS[pin] - '0');
+}
+#endif
+
+template <uint8_t PIN>
+struct LiquidCrystalPin {
+#ifdef LCD_T_DIRECT
+  static_assert(PIN < sizeof(LCD_T_PORTS) - 1, "pin not available on this board");
+
+  static volatile uint8_t &out() { return *(volatile uint8_t *)lcdPinPort(PIN); }
+  static volatile uint8_t &ddr() { return *(volatile uint8_t *)(lcdPinPort(PIN) - 1); }
+
+  static void output() {
+    uint8_t oldSREG = SREG;
+    cli();
+    ddr() |= lcdPinMask(PIN);
+    SREG = oldSREG;
+  }
+
+  static void write(uint8_t value) {
+    // ports below 0x40 get a single sbi/cbi, the others need a guarded RMW
+    uint8_t oldSREG = SREG;
+    if (lcdPinPort(PIN) >= 0x40) {
+      cli();
+    }
+    if (value) {
+      out() |= lcdPinMask(PIN);
+    } else {
+      out() &= ~lcdPinMask(PIN);
+    }
+    SREG = oldSREG;
+  }
+#else
+  static void output() { pinMode(PIN, OUTPUT); }
+  static void write(uint8_t value) { digitalWrite(PIN, value); }
+#endif
+};
+
+template <uint8_t RS, uint8_t EN, uint8_t D4, uint8_t D5, uint8_t D6, uint8_t D7>
+class LiquidCrystalT : public Print {
+public:
+  LiquidCrystalT() : _displaycontrol(0), _displaymode(0), _numlines(1), _cols(16) {}
+
+  void begin(uint8_t cols, uint8_t lines, uint8_t dotsize = LCD_5x8DOTS) {
+    uint8_t displayfunction = LCD_4BITMODE | LCD_1LINE | LCD_5x8DOTS;
+    if (lines > 1) {
+      displayfunction |= LCD_2LINE;
+    }
+    _numlines = lines;
+    _cols = cols;
+
+    // for some 1 line displays you can select a 10 pixel high font
+    if ((dotsize != LCD_5x8DOTS) && (lines == 1)) {
+      displayfunction |= LCD_5x10DOTS;
+    }
+
+    LiquidCrystalPin<RS>::output();
+    LiquidCrystalPin<EN>::output();
+    LiquidCrystalPin<D4>::output();
+    LiquidCrystalPin<D5>::output();
+    LiquidCrystalPin<D6>::output();
+    LiquidCrystalPin<D7>::output();
+
+    // same power-on sequence as LiquidCrystal::begin(), HD44780 figure 24
+    delayMicroseconds(50000);
+    LiquidCrystalPin<RS>::write(LOW);
+    LiquidCrystalPin<EN>::write(LOW);
+
+    write4bits(0x03);
+    delayMicroseconds(4500); // wait min 4.1ms
+    write4bits(0x03);
+    delayMicroseconds(4500); // wait min 4.1ms
+    write4bits(0x03);
+    delayMicroseconds(150);
+    write4bits(0x02);
+    delayMicroseconds(100);
+
+    command(LCD_FUNCTIONSET | displayfunction);
+
+    _displaycontrol = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
+    display();
+
+    clear();
+
+    _displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
+    command(LCD_ENTRYMODESET | _displaymode);
+  }
+
+  void clear() {
+    command(LCD_CLEARDISPLAY);
+    delayMicroseconds(2000);  // this command takes a long time!
+  }
+  void home() {
+    command(LCD_RETURNHOME);
+    delayMicroseconds(2000);  // this command takes a long time!
+  }
+
+  void noDisplay() { setControl(_displaycontrol & ~LCD_DISPLAYON); }
+  void display() { setControl(_displaycontrol | LCD_DISPLAYON); }
+  void noBlink() { setControl(_displaycontrol & ~LCD_BLINKON); }
+  void blink() { setControl(_displaycontrol | LCD_BLINKON); }
+  void noCursor() { setControl(_displaycontrol & ~LCD_CURSORON); }
+  void cursor() { setControl(_displaycontrol | LCD_CURSORON); }
+  void scrollDisplayLeft() { command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVELEFT); }
+  void scrollDisplayRight() { command(LCD_CURSORSHIFT | LCD_DISPLAYMOVE | LCD_MOVERIGHT); }
+  void leftToRight() { setMode(_displaymode | LCD_ENTRYLEFT); }
+  void rightToLeft() { setMode(_displaymode & ~LCD_ENTRYLEFT); }
+  void autoscroll() { setMode(_displaymode | LCD_ENTRYSHIFTINCREMENT); }
+  void noAutoscroll() { setMode(_displaymode & ~LCD_ENTRYSHIFTINCREMENT); }
+
+  void createChar(uint8_t location, uint8_t charmap[]) {
+    location &= 0x7; // we only have 8 locations 0-7
+    command(LCD_SETCGRAMADDR | (location << 3));
+    for (int i = 0; i < 8; i++) {
+      write(charmap[i]);
+    }
+  }
+
+  void setCursor(uint8_t col, uint8_t row) {
+    if (row >= 4) {
+      row = 3;
+    }
+    if (row >= _numlines) {
+      row = _numlines - 1;    // we count rows starting w/ 0
+    }
+    // row offsets 0x00, 0x40, cols, 0x40 + cols, as in LiquidCrystal
+    uint8_t offset = (row & 1) ? 0x40 : 0x00;
+    if (row & 2) {
+      offset += _cols;
+    }
+    command(LCD_SETDDRAMADDR | (col + offset));
+  }
+
+  virtual size_t write(uint8_t value) {
+    send(value, HIGH);
+    return 1; // assume success
+  }
+  void command(uint8_t value) { send(value, LOW); }
+
+  using Print::write;
+
+private:
+  void setControl(uint8_t control) {
+    _displaycontrol = control;
+    command(LCD_DISPLAYCONTROL | _displaycontrol);
+  }
+  void setMode(uint8_t mode) {
+    _displaymode = mode;
+    command(LCD_ENTRYMODESET | _displaymode);
+  }
+
+  void send(uint8_t value, uint8_t mode) {
+    LiquidCrystalPin<RS>::write(mode);
+    writeNibble(value >> 4);
+    pulseEnable();
+    writeNibble(value);
+    pulseEnable();
+    delayMicroseconds(100);   // commands need >37 us to settle
+  }
+
+  void write4bits(uint8_t value) {
+    writeNibble(value);
+    pulseEnable();
+  }
+
+  static void pulseEnable() {
+    LiquidCrystalPin<EN>::write(HIGH);
+    delayMicroseconds(1);    // enable pulse must be >450 ns
+    LiquidCrystalPin<EN>::write(LOW);
+    delayMicroseconds(1);
+  }
+
+  static void writeNibble(uint8_t value) {
+#ifdef LCD_T_DIRECT
+    if (lcdPinPort(D4) == lcdPinPort(D5) && lcdPinPort(D4) == lcdPinPort(D6) &&
+        lcdPinPort(D4) == lcdPinPort(D7)) {
+      // all data pins on one port: one masked read-modify-write
+      const uint8_t mask = lcdPinMask(D4) | lcdPinMask(D5) | lcdPinMask(D6) | lcdPinMask(D7);
+      uint8_t bits = 0;
+      if (value & 0x01) bits |= lcdPinMask(D4);
+      if (value & 0x02) bits |= lcdPinMask(D5);
+      if (value & 0x04) bits |= lcdPinMask(D6);
+      if (value & 0x08) bits |= lcdPinMask(D7);
+
+      volatile uint8_t &out = LiquidCrystalPin<D4>::out();
+      uint8_t oldSREG = SREG;
+      cli();
+      out = (out & ~mask) | bits;
+      SREG = oldSREG;
+      return;
+    }
+#endif
+    LiquidCrystalPin<D4>::write(value & 0x01);
+    LiquidCrystalPin<D5>::write(value & 0x02);
+    LiquidCrystalPin<D6>::write(value & 0x04);
+    LiquidCrystalPin<D7>::write(value & 0x08);
+  }
+
+  uint8_t _displaycontrol;
+  uint8_t _displaymode;
+  uint8_t _numlines;
+  uint8_t _cols;
+};
+
+#endif
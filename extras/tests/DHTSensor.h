@@ -0,0 +1,182 @@
+// Simulated DHT sensor on one pin of the host core.
+//
+// Once the host has held the line low for at least minStartLow us and
+// let go, the sensor answers responseDelay us later with a frame: an 80 us
+// low and 80 us high preamble, 40 bits of a 50 us low and a 26 us (0) or
+// 70 us (1) high, and a final 50 us low.  That is DHT_EDGES falling edges.
+// clockPercent stretches or shrinks every pulse, as a sensor's RC clock
+// does.
+
+#ifndef DHTSensor_h
+#define DHTSensor_h
+
+#include "ArduinoHost.h"
+
+class DHTSensor : public HostDevice {
+public:
+  DHTSensor(uint8_t pin) :
+    minStartLow(18000),
+    responseDelay(30),
+    clockPercent(100),
+    reply(true),
+    bitsSent(40),
+    corruptChecksum(false),
+    frames(0),
+    _pin(pin),
+    _lowSince(HOST_NO_EDGE),
+    _start(HOST_NO_EDGE)
+  {
+    setBytes(0, 0, 0, 0);
+    hostAttach(pin, this);
+  }
+
+  // DHT11 frame: whole and tenths parts of humidity and temperature; DHT
+  // decodes a negative temperature t with tenths d as t + d / 10
+  void setDHT11(uint8_t humidity, uint8_t humidityTenths, int8_t temperature, uint8_t temperatureTenths)
+  {
+    if (temperature < 0) {
+      setBytes(humidity, humidityTenths, -1 - temperature, temperatureTenths | 0x80);
+    } else {
+      setBytes(humidity, humidityTenths, temperature, temperatureTenths);
+    }
+  }
+
+  // DHT22 frame: values in tenths
+  void setDHT22(uint16_t humidity10, int16_t temperature10)
+  {
+    uint16_t t = temperature10 < 0 ? (uint16_t)(-temperature10) | 0x8000 : temperature10;
+    setBytes(humidity10 >> 8, humidity10 & 0xFF, t >> 8, t & 0xFF);
+  }
+
+  void setBytes(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3)
+  {
+    _bytes[0] = b0;
+    _bytes[1] = b1;
+    _bytes[2] = b2;
+    _bytes[3] = b3;
+    _bytes[4] = (uint8_t)(b0 + b1 + b2 + b3);
+  }
+
+  virtual void pinMode(uint8_t pin, uint8_t mode)
+  {
+    (void)pin;
+    (void)mode;
+    update();
+  }
+
+  virtual void digitalWrite(uint8_t pin, uint8_t value)
+  {
+    (void)pin;
+    (void)value;
+    update();
+  }
+
+  virtual int level(uint8_t pin, host_time_t now)
+  {
+    (void)pin;
+    if (_start == HOST_NO_EDGE || now < _start) {
+      return -1;
+    }
+
+    host_time_t t = now - _start;
+    if (t < scaled(80)) {
+      return LOW;
+    }
+    if (t < scaled(160)) {
+      return HIGH;
+    }
+    t -= scaled(160);
+    for (uint8_t i = 0; i < bitsSent; i++) {
+      host_time_t high = scaled(bit(i) ? 70 : 26);
+      if (t < scaled(50)) {
+        return LOW;
+      }
+      if (t < scaled(50) + high) {
+        return HIGH;
+      }
+      t -= scaled(50) + high;
+    }
+    // the final low; after it, or after a cut-off frame, the pull-up
+    if (bitsSent == 40 && t < scaled(50)) {
+      return LOW;
+    }
+    return -1;
+  }
+
+  virtual host_time_t nextFallingEdge(uint8_t pin, host_time_t after)
+  {
+    (void)pin;
+    if (_start == HOST_NO_EDGE) {
+      return HOST_NO_EDGE;
+    }
+
+    // the response, then the start of every bit's low and the final low
+    host_time_t edge = _start;
+    if (edge > after) {
+      return edge;
+    }
+    edge += scaled(160);
+    for (uint8_t i = 0; i < bitsSent; i++) {
+      if (edge > after) {
+        return edge;
+      }
+      edge += scaled(50) + scaled(bit(i) ? 70 : 26);
+    }
+    if (bitsSent == 40 && edge > after) {
+      return edge;
+    }
+    return HOST_NO_EDGE;
+  }
+
+  unsigned long minStartLow;   // us the host has to hold the line low
+  unsigned long responseDelay; // us from the release to the reply
+  unsigned int clockPercent;   // pulse lengths in percent of nominal
+  bool reply;                  // false: never answer
+  uint8_t bitsSent;            // fewer than 40: stop sending after that many
+  bool corruptChecksum;
+  unsigned int frames;         // replies started
+
+private:
+  host_time_t scaled(unsigned long us) { return (host_time_t)us * clockPercent / 100; }
+
+  bool bit(uint8_t i)
+  {
+    uint8_t b = _bytes[i / 8];
+    if (i / 8 == 4 && corruptChecksum) {
+      b ^= 0x01;
+    }
+    return (b >> (7 - i % 8)) & 1;
+  }
+
+  void update()
+  {
+    bool low = hostPinMode(_pin) == OUTPUT && hostPinOutput(_pin) == LOW;
+    host_time_t now = hostNow();
+
+    if (low) {
+      if (_lowSince == HOST_NO_EDGE) {
+        _lowSince = now;
+      }
+      // a new start signal ends any reply
+      _start = HOST_NO_EDGE;
+      return;
+    }
+    if (_lowSince == HOST_NO_EDGE) {
+      return;
+    }
+
+    host_time_t held = now - _lowSince;
+    _lowSince = HOST_NO_EDGE;
+    if (reply && held >= minStartLow) {
+      _start = now + responseDelay;
+      frames++;
+    }
+  }
+
+  uint8_t _pin;
+  uint8_t _bytes[5];
+  host_time_t _lowSince;
+  host_time_t _start;
+};
+
+#endif
@@ -0,0 +1,282 @@
+// Simulated HD44780 character LCD controller on the host core.
+//
+// Attached to the enable pin, it latches RS and the data pins on every
+// falling edge of enable and runs each instruction or character as it
+// completes: an 8-bit interface after power-up, 4-bit once a function set
+// clears DL, then DDRAM and CGRAM writes through the address counter and
+// entry mode.  Anything latched while the previous instruction is still
+// executing (37 us, 1.52 ms for clear and home, at the nominal 270 kHz
+// clock; timePercent stretches them) counts as an overrun.
+// Strobes with RW high are reads: while enable is high the controller
+// drives the busy flag and address counter onto the data pins (high
+// nibble first on a 4-bit bus), and latches nothing.
+//
+// Constructed without pins it is fed through latch() instead, e.g. by a
+// port expander simulation.
+
+#ifndef HD44780_h
+#define HD44780_h
+
+#include <string>
+
+#include "ArduinoHost.h"
+
+#define HD44780_EXEC_US 37
+#define HD44780_LONG_EXEC_US 1520
+#define HD44780_NO_PIN 255
+
+class HD44780 : public HostDevice {
+public:
+  HD44780()
+  {
+    wire(HD44780_NO_PIN, HD44780_NO_PIN, HD44780_NO_PIN, 0, NULL);
+  }
+
+  // 4-bit wiring with RW tied low, as LiquidCrystal(rs, enable, d4, d5, d6, d7)
+  HD44780(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
+  {
+    const uint8_t data[] = { d4, d5, d6, d7 };
+    wire(rs, HD44780_NO_PIN, enable, 4, data);
+  }
+
+  // 4-bit wiring with RW, as LiquidCrystal(rs, rw, enable, d4, d5, d6, d7)
+  HD44780(uint8_t rs, uint8_t rw, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
+  {
+    const uint8_t data[] = { d4, d5, d6, d7 };
+    wire(rs, rw, enable, 4, data);
+  }
+
+  // 8-bit wiring, as LiquidCrystal(rs, rw, enable, d0, ..., d7)
+  HD44780(uint8_t rs, uint8_t rw, uint8_t enable,
+          uint8_t d0, uint8_t d1, uint8_t d2, uint8_t d3,
+          uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7)
+  {
+    const uint8_t data[] = { d0, d1, d2, d3, d4, d5, d6, d7 };
+    wire(rs, rw, enable, 8, data);
+  }
+
+  virtual void digitalWrite(uint8_t pin, uint8_t value)
+  {
+    if (pin != _enable) {
+      return;
+    }
+    bool falling = _enableHigh && value == LOW;
+    _enableHigh = value == HIGH;
+    if (!falling) {
+      return;
+    }
+    if (reading()) {
+      _readLowNibbleNext = !_eightBit && !_readLowNibbleNext;
+      return;
+    }
+
+    // on a 4-bit wiring D0..D3 are not connected
+    uint8_t bus = 0;
+    for (uint8_t i = 0; i < _width; i++) {
+      if (hostPinOutput(_data[i]) == HIGH) {
+        bus |= 1 << (i + 8 - _width);
+      }
+    }
+    latch(hostPinOutput(_rs) == HIGH, bus, hostNow());
+  }
+
+  // the busy flag and address counter on the data pins during a read
+  virtual int level(uint8_t pin, host_time_t now)
+  {
+    if (!reading() || !_enableHigh) {
+      return -1;
+    }
+    uint8_t status = (hung || now < _busyUntil ? 0x80 : 0) | _address;
+    uint8_t bus = _readLowNibbleNext ? status << 4 : status;
+    for (uint8_t i = 0; i < _width; i++) {
+      if (_data[i] == pin) {
+        return (bus >> (i + 8 - _width)) & 1;
+      }
+    }
+    return -1;
+  }
+
+  // RS and D7..D0 as the controller sees them at a falling edge of enable
+  // at time at; in 4-bit mode only D7..D4 are used
+  void latch(bool rs, uint8_t bus, host_time_t at)
+  {
+    latches++;
+    if (at < _busyUntil) {
+      overruns++;
+    }
+
+    if (_eightBit) {
+      execute(rs, bus, at);
+    } else if (!_lowNibbleNext) {
+      _highNibble = bus & 0xF0;
+      _lowNibbleNext = true;
+    } else {
+      _lowNibbleNext = false;
+      execute(rs, _highNibble | bus >> 4, at);
+    }
+  }
+
+  // length characters of DDRAM from address
+  std::string text(uint8_t address, uint8_t length) const
+  {
+    std::string s;
+    for (uint8_t i = 0; i < length; i++) {
+      s += (char)_ddram[(address + i) & 0x7F];
+    }
+    return s;
+  }
+
+  // a row of a cols-wide display, at LiquidCrystal's row offsets
+  std::string row(uint8_t r, uint8_t cols = 16) const
+  {
+    const uint8_t offsets[] = { 0x00, 0x40, cols, (uint8_t)(0x40 + cols) };
+    return text(offsets[r & 3], cols);
+  }
+
+  // the 8 rows of custom character location (0-7)
+  const uint8_t *glyph(uint8_t location) const { return &_cgram[(location & 7) * 8]; }
+
+  bool eightBit() const { return _eightBit; }
+  bool twoLines() const { return _functionSet & 0x08; }
+  uint8_t address() const { return _address; }
+  uint8_t entryMode() const { return _entryMode; }
+  uint8_t displayControl() const { return _displayControl; }
+  host_time_t busyUntil() const { return _busyUntil; }
+
+  unsigned int timePercent;  // instruction times in percent of nominal
+  bool hung;                 // busy flag stuck high, as a dead controller
+  unsigned long latches;     // falling edges of enable that wrote
+  unsigned long executed;    // instructions and characters run
+  unsigned long characters;  // of those, DDRAM/CGRAM data writes
+  unsigned long overruns;    // latches while still busy
+
+private:
+  bool reading() const { return _rw != HD44780_NO_PIN && hostPinOutput(_rw) == HIGH; }
+
+  void wire(uint8_t rs, uint8_t rw, uint8_t enable, uint8_t width, const uint8_t *data)
+  {
+    _rs = rs;
+    _rw = rw;
+    _enable = enable;
+    _width = width;
+    for (uint8_t i = 0; i < width; i++) {
+      _data[i] = data[i];
+    }
+    _enableHigh = false;
+    _readLowNibbleNext = false;
+
+    // power-on reset: cleared, 8-bit, one line, display off, incrementing
+    memset(_ddram, ' ', sizeof(_ddram));
+    memset(_cgram, 0, sizeof(_cgram));
+    _eightBit = true;
+    _lowNibbleNext = false;
+    _highNibble = 0;
+    _functionSet = 0x30;
+    _entryMode = 0x02;
+    _displayControl = 0;
+    _address = 0;
+    _cgramSelected = false;
+    _busyUntil = 0;
+    timePercent = 100;
+    hung = false;
+    latches = executed = characters = overruns = 0;
+
+    if (enable != HD44780_NO_PIN) {
+      hostAttach(enable, this);
+    }
+    // the data pins are only driven for reads
+    if (rw != HD44780_NO_PIN) {
+      for (uint8_t i = 0; i < width; i++) {
+        hostAttach(data[i], this);
+      }
+    }
+  }
+
+  void execute(bool rs, uint8_t value, host_time_t at)
+  {
+    host_time_t time = HD44780_EXEC_US;
+    executed++;
+
+    if (rs) {
+      characters++;
+      if (_cgramSelected) {
+        _cgram[_address & 0x3F] = value;
+      } else {
+        _ddram[_address & 0x7F] = value;
+      }
+      step(_entryMode & 0x02);
+    } else if (value & 0x80) {
+      _address = value & 0x7F;
+      _cgramSelected = false;
+    } else if (value & 0x40) {
+      _address = value & 0x3F;
+      _cgramSelected = true;
+    } else if (value & 0x20) {
+      _functionSet = value;
+      _eightBit = value & 0x10;
+      _lowNibbleNext = false;
+    } else if (value & 0x10) {
+      // display shifts leave the RAM alone
+      if (!(value & 0x08)) {
+        step(value & 0x04);
+      }
+    } else if (value & 0x08) {
+      _displayControl = value & 0x07;
+    } else if (value & 0x04) {
+      _entryMode = value & 0x03;
+    } else if (value & 0x02) {
+      _address = 0;
+      _cgramSelected = false;
+      time = HD44780_LONG_EXEC_US;
+    } else if (value & 0x01) {
+      memset(_ddram, ' ', sizeof(_ddram));
+      _address = 0;
+      _cgramSelected = false;
+      _entryMode |= 0x02;
+      time = HD44780_LONG_EXEC_US;
+    }
+
+    _busyUntil = at + time * timePercent / 100;
+  }
+
+  // move the address counter; DDRAM wraps from the end of one line to the
+  // start of the next (0x00-0x27 and 0x40-0x67, or 0x00-0x4F on one line)
+  void step(bool up)
+  {
+    if (_cgramSelected) {
+      _address = (_address + (up ? 1 : -1)) & 0x3F;
+    } else if (twoLines()) {
+      if (up) {
+        _address = _address == 0x27 ? 0x40 : _address == 0x67 ? 0x00 : _address + 1;
+      } else {
+        _address = _address == 0x00 ? 0x67 : _address == 0x40 ? 0x27 : _address - 1;
+      }
+    } else if (up) {
+      _address = _address == 0x4F ? 0x00 : _address + 1;
+    } else {
+      _address = _address == 0x00 ? 0x4F : _address - 1;
+    }
+  }
+
+  uint8_t _rs;
+  uint8_t _rw;
+  uint8_t _enable;
+  uint8_t _width;
+  uint8_t _data[8];
+  bool _enableHigh;
+  bool _readLowNibbleNext;
+
+  uint8_t _ddram[128];
+  uint8_t _cgram[64];
+  bool _eightBit;
+  bool _lowNibbleNext;
+  uint8_t _highNibble;
+  uint8_t _functionSet;
+  uint8_t _entryMode;
+  uint8_t _displayControl;
+  uint8_t _address;
+  bool _cgramSelected;
+  host_time_t _busyUntil;
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include <stdio.h>
+
+#include "ArduinoHost.h"
+
+#define HOST_INTERRUPTS 6
+
+static const uint8_t interruptPins[HOST_INTERRUPTS] = {2, 3, 21, 20, 19, 18};
+
+static host_time_t now;
+static uint8_t modes[HOST_PINS];
+static uint8_t outputs[HOST_PINS];
+static HostDevice *devices[HOST_PINS];
+static void (*isrs[HOST_INTERRUPTS])(void);
+static bool interruptsOn;
+static bool inIsr;
+
+// periodic timer interrupt: the next compare match, and how late it runs
+static void (*timerIsr)(void);
+static unsigned long timerPeriod;
+static host_time_t timerNext;
+static unsigned long timerLate;
+
+void hostReset()
+{
+  now = 0;
+  for (int i = 0; i < HOST_PINS; i++) {
+    modes[i] = INPUT;
+    outputs[i] = LOW;
+    devices[i] = NULL;
+  }
+  for (int i = 0; i < HOST_INTERRUPTS; i++) {
+    isrs[i] = NULL;
+  }
+  interruptsOn = true;
+  inIsr = false;
+  timerIsr = NULL;
+  timerLate = 0;
+}
+
+void hostAttach(uint8_t pin, HostDevice *device)
+{
+  if (pin < HOST_PINS) {
+    devices[pin] = device;
+  }
+}
+
+void hostTimer(void (*isr)(void), unsigned long period)
+{
+  timerIsr = isr;
+  timerPeriod = period;
+  timerNext = now + period;
+  timerLate = 0;
+}
+
+void hostTimerLate(unsigned long us)
+{
+  timerLate = us;
+}
+
+host_time_t hostNow()
+{
+  return now;
+}
+
+// Move the clock to target, running the interrupt of every falling edge
+// and timer tick passed on the way.  An edge while interrupts are off is
+// lost; a tick is held off until they are back on.
+static void advanceTo(host_time_t target)
+{
+  while (interruptsOn && !inIsr) {
+    host_time_t first = HOST_NO_EDGE;
+    int irq = -1;
+
+    for (int i = 0; i < HOST_INTERRUPTS; i++) {
+      uint8_t pin = interruptPins[i];
+      if (isrs[i] == NULL || devices[pin] == NULL) {
+        continue;
+      }
+      host_time_t edge = devices[pin]->nextFallingEdge(pin, now);
+      if (edge < first) {
+        first = edge;
+        irq = i;
+      }
+    }
+
+    // a tick held off while interrupts were off runs as soon as they are on
+    if (timerIsr != NULL) {
+      host_time_t tick = timerNext + timerLate;
+      if (tick < now) {
+        tick = now;
+      }
+      if (tick < first) {
+        first = tick;
+        irq = HOST_INTERRUPTS;
+      }
+    }
+
+    if (irq < 0 || first > target) {
+      break;
+    }
+
+    now = first;
+    inIsr = true;
+    if (irq == HOST_INTERRUPTS) {
+      // like the compare flag, ticks missed meanwhile run once
+      timerLate = 0;
+      while (timerNext <= now) {
+        timerNext += timerPeriod;
+      }
+      timerIsr();
+    } else {
+      isrs[irq]();
+    }
+    inIsr = false;
+  }
+
+  if (now < target) {
+    now = target;
+  }
+}
+
+void hostAdvance(unsigned long us)
+{
+  advanceTo(now + us);
+}
+
+uint8_t hostPinMode(uint8_t pin)
+{
+  return pin < HOST_PINS ? modes[pin] : INPUT;
+}
+
+uint8_t hostPinOutput(uint8_t pin)
+{
+  return pin < HOST_PINS ? outputs[pin] : LOW;
+}
+
+int digitalPinToInterrupt(uint8_t pin)
+{
+  for (int i = 0; i < HOST_INTERRUPTS; i++) {
+    if (interruptPins[i] == pin) {
+      return i;
+    }
+  }
+  return NOT_AN_INTERRUPT;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (pin >= HOST_PINS) {
+    return;
+  }
+  modes[pin] = mode;
+  if (devices[pin]) {
+    devices[pin]->pinMode(pin, mode);
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (pin >= HOST_PINS) {
+    return;
+  }
+  outputs[pin] = value ? HIGH : LOW;
+  if (devices[pin]) {
+    devices[pin]->digitalWrite(pin, outputs[pin]);
+  }
+}
+
+int digitalRead(uint8_t pin)
+{
+  int level = -1;
+
+  if (pin < HOST_PINS) {
+    if (devices[pin]) {
+      level = devices[pin]->level(pin, now);
+    }
+    if (level < 0) {
+      if (modes[pin] == OUTPUT) {
+        level = outputs[pin];
+      } else {
+        level = modes[pin] == INPUT_PULLUP ? HIGH : LOW;
+      }
+    }
+  }
+
+  advanceTo(now + HOST_CALL_US);
+  return level < 0 ? LOW : level;
+}
+
+unsigned long millis()
+{
+  unsigned long ms = (unsigned long)(now / 1000);
+  advanceTo(now + HOST_CALL_US);
+  return ms;
+}
+
+unsigned long micros()
+{
+  unsigned long us = (unsigned long)now;
+  advanceTo(now + HOST_CALL_US);
+  return us;
+}
+
+void delay(unsigned long ms)
+{
+  advanceTo(now + (host_time_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  advanceTo(now + us);
+}
+
+void yield()
+{
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode)
+{
+  // the libraries only use falling edges
+  if (interrupt < HOST_INTERRUPTS && mode == FALLING) {
+    isrs[interrupt] = isr;
+  }
+}
+
+void detachInterrupt(uint8_t interrupt)
+{
+  if (interrupt < HOST_INTERRUPTS) {
+    isrs[interrupt] = NULL;
+  }
+}
+
+void noInterrupts()
+{
+  interruptsOn = false;
+}
+
+void interrupts()
+{
+  interruptsOn = true;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t n = 0;
+  while (n < length) {
+    int c = read();
+    if (c < 0) {
+      break;
+    }
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+size_t Stream::readBytesUntil(char terminator, char *buffer, size_t length)
+{
+  size_t n = 0;
+  while (n < length) {
+    int c = read();
+    if (c < 0 || c == terminator) {
+      break;
+    }
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+HardwareSerial Serial;
+
+// static constructors in the libraries may read the clock
+static struct HostInit {
+  HostInit() { hostReset(); }
+} hostInit;
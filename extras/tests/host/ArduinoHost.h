@@ -0,0 +1,60 @@
+// Simulation side of the host Arduino core.
+//
+// Time is a counter in microseconds.  It advances when the code under test
+// calls delay()/delayMicroseconds(), by HOST_CALL_US on every micros(),
+// millis() and digitalRead() (so polling loops make progress), and when a
+// test calls hostAdvance().  Devices attached to pins see every pinMode()
+// and digitalWrite() on them and may drive the pin's level; falling edges
+// they report fire interrupts attached with attachInterrupt() as time
+// passes them.  hostTimer() adds a periodic timer interrupt.
+
+#ifndef ArduinoHost_h
+#define ArduinoHost_h
+
+#include "Arduino.h"
+
+#define HOST_PINS 70
+#define HOST_CALL_US 1
+#define HOST_NO_EDGE 0xFFFFFFFFFFFFFFFFULL
+
+typedef unsigned long long host_time_t;
+
+class HostDevice {
+public:
+  virtual ~HostDevice() {}
+
+  // the sketch changed the pin
+  virtual void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+  virtual void digitalWrite(uint8_t pin, uint8_t value) { (void)pin; (void)value; }
+
+  // level the device pulls the pin to at time now, or -1 when it lets go
+  virtual int level(uint8_t pin, host_time_t now) { (void)pin; (void)now; return -1; }
+
+  // first falling edge the device makes after time after
+  virtual host_time_t nextFallingEdge(uint8_t pin, host_time_t after)
+  {
+    (void)pin;
+    (void)after;
+    return HOST_NO_EDGE;
+  }
+};
+
+// back to time 0 with every pin an unattached input
+void hostReset();
+
+void hostAttach(uint8_t pin, HostDevice *device);
+host_time_t hostNow();
+
+// a timer interrupt every period us from now on, as a timer in CTC mode
+// gives; isr NULL stops it
+void hostTimer(void (*isr)(void), unsigned long period);
+// run the next tick us late (held off by another interrupt) without
+// moving the ones after it
+void hostTimerLate(unsigned long us);
+void hostAdvance(unsigned long us);
+
+// what the sketch last did to a pin
+uint8_t hostPinMode(uint8_t pin);
+uint8_t hostPinOutput(uint8_t pin);
+
+#endif
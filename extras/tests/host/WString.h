@@ -0,0 +1,57 @@
+// Host stand-in for the Arduino core's String, backed by std::string.  Only
+// the members the libraries and tests use are provided.
+
+#ifndef String_class_h
+#define String_class_h
+
+#include <stdlib.h>
+#include <string>
+
+class __FlashStringHelper;
+
+class String {
+public:
+  String() {}
+  String(const char *cstr) { if (cstr) _s = cstr; }
+  String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+  String(char c) : _s(1, c) {}
+  String(int value) : _s(std::to_string(value)) {}
+  String(unsigned int value) : _s(std::to_string(value)) {}
+  String(long value) : _s(std::to_string(value)) {}
+  String(unsigned long value) : _s(std::to_string(value)) {}
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  bool reserve(unsigned int size) { _s.reserve(size); return true; }
+
+  char operator[](unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+
+  String &operator+=(const String &rhs) { _s += rhs._s; return *this; }
+  String &operator+=(const char *rhs) { if (rhs) _s += rhs; return *this; }
+  String &operator+=(char c) { _s += c; return *this; }
+  String operator+(const String &rhs) const { String s(*this); s += rhs; return s; }
+
+  bool operator==(const String &rhs) const { return _s == rhs._s; }
+  bool operator==(const char *rhs) const { return _s == (rhs ? rhs : ""); }
+  bool operator!=(const String &rhs) const { return !(*this == rhs); }
+  bool operator!=(const char *rhs) const { return !(*this == rhs); }
+
+  bool startsWith(const String &prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+  int indexOf(char c, unsigned int from = 0) const
+  {
+    std::string::size_type i = _s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+  String substring(unsigned int from) const { return from < _s.size() ? String(_s.substr(from).c_str()) : String(); }
+  String substring(unsigned int from, unsigned int to) const
+  {
+    return from < to && from < _s.size() ? String(_s.substr(from, to - from).c_str()) : String();
+  }
+  long toInt() const { return atol(_s.c_str()); }
+  float toFloat() const { return atof(_s.c_str()); }
+
+private:
+  std::string _s;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "Wire.h"
+
+TwoWire::TwoWire()
+{
+  reset();
+}
+
+void TwoWire::reset()
+{
+  for (int i = 0; i < 128; i++) {
+    _devices[i] = NULL;
+  }
+  _length = 0;
+  _overflow = false;
+  _transmissions = 0;
+  _bytes = 0;
+}
+
+void TwoWire::attach(uint8_t address, HostWireDevice *device)
+{
+  _devices[address & 0x7F] = device;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  _address = address & 0x7F;
+  _length = 0;
+  _overflow = false;
+}
+
+// like the AVR library, bytes past the buffer are dropped
+size_t TwoWire::write(uint8_t data)
+{
+  if (_length >= WIRE_BUFFER_LENGTH) {
+    _overflow = true;
+    return 0;
+  }
+  _buffer[_length++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+  size_t n = 0;
+  while (n < length && write(data[n])) {
+    n++;
+  }
+  return n;
+}
+
+// 0 on success, 1 if the buffer overflowed, 2 if nothing answered
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+  if (_overflow) {
+    return 1;
+  }
+  if (_devices[_address] == NULL) {
+    return 2;
+  }
+
+  _transmissions++;
+  _bytes += _length + 1;
+  // ~90 us per byte at 100 kHz, address included
+  delayMicroseconds((_length + 1) * 90);
+  _devices[_address]->receive(_buffer, _length);
+  return 0;
+}
+
+TwoWire Wire;
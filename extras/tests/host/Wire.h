@@ -0,0 +1,45 @@
+// Host stand-in for the Wire library.  Each transmission is handed whole
+// to the HostWireDevice registered at its address, if any.
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include "Arduino.h"
+
+#define WIRE_BUFFER_LENGTH 32
+
+class HostWireDevice {
+public:
+  virtual ~HostWireDevice() {}
+  virtual void receive(const uint8_t *data, size_t length) = 0;
+};
+
+class TwoWire {
+public:
+  TwoWire();
+
+  void begin() {}
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+
+  // host side
+  void attach(uint8_t address, HostWireDevice *device);
+  void reset();
+  unsigned int transmissions() const { return _transmissions; }
+  unsigned long bytes() const { return _bytes; }
+
+private:
+  HostWireDevice *_devices[128];
+  uint8_t _address;
+  uint8_t _buffer[WIRE_BUFFER_LENGTH];
+  size_t _length;
+  bool _overflow;
+  unsigned int _transmissions;
+  unsigned long _bytes;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,904 @@
+/*
+  Host stand-in for the subset of cJSON that the Arduino_JSON library
+  calls, see cJSON.h.  Written for the tests, not for speed.
+*/
+
+#include <ctype.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+static void *(*cjson_malloc)(size_t) = malloc;
+static void (*cjson_free)(void *) = free;
+
+void cJSON_InitHooks(cJSON_Hooks *hooks)
+{
+    cjson_malloc = (hooks && hooks->malloc_fn) ? hooks->malloc_fn : malloc;
+    cjson_free = (hooks && hooks->free_fn) ? hooks->free_fn : free;
+}
+
+void *cJSON_malloc(size_t size)
+{
+    return cjson_malloc(size);
+}
+
+void cJSON_free(void *object)
+{
+    cjson_free(object);
+}
+
+static char *copy_string(const char *s)
+{
+    size_t length = strlen(s) + 1;
+    char *copy = (char *)cjson_malloc(length);
+
+    if (copy) {
+        memcpy(copy, s, length);
+    }
+    return copy;
+}
+
+static cJSON *new_item(int type)
+{
+    cJSON *item = (cJSON *)cjson_malloc(sizeof(cJSON));
+
+    if (item) {
+        memset(item, 0, sizeof(cJSON));
+        item->type = type;
+    }
+    return item;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    while (item) {
+        cJSON *next = item->next;
+
+        if (!(item->type & cJSON_IsReference) && item->child) {
+            cJSON_Delete(item->child);
+        }
+        if (!(item->type & cJSON_IsReference) && item->valuestring) {
+            cjson_free(item->valuestring);
+        }
+        if (!(item->type & cJSON_StringIsConst) && item->string) {
+            cjson_free(item->string);
+        }
+        cjson_free(item);
+        item = next;
+    }
+}
+
+/* type checks */
+
+cJSON_bool cJSON_IsInvalid(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_Invalid; }
+cJSON_bool cJSON_IsFalse(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_False; }
+cJSON_bool cJSON_IsTrue(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_True; }
+cJSON_bool cJSON_IsBool(const cJSON * const item) { return item && (item->type & (cJSON_True | cJSON_False)) != 0; }
+cJSON_bool cJSON_IsNull(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_NULL; }
+cJSON_bool cJSON_IsNumber(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_Number; }
+cJSON_bool cJSON_IsString(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_String; }
+cJSON_bool cJSON_IsArray(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_Array; }
+cJSON_bool cJSON_IsObject(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_Object; }
+cJSON_bool cJSON_IsRaw(const cJSON * const item) { return item && (item->type & 0xFF) == cJSON_Raw; }
+
+/* construction */
+
+cJSON *cJSON_CreateNull(void) { return new_item(cJSON_NULL); }
+cJSON *cJSON_CreateTrue(void) { return new_item(cJSON_True); }
+cJSON *cJSON_CreateFalse(void) { return new_item(cJSON_False); }
+cJSON *cJSON_CreateArray(void) { return new_item(cJSON_Array); }
+cJSON *cJSON_CreateObject(void) { return new_item(cJSON_Object); }
+
+static void set_number(cJSON *item, double num)
+{
+    item->valuedouble = num;
+    if (num >= INT_MAX) {
+        item->valueint = INT_MAX;
+    } else if (num <= (double)INT_MIN) {
+        item->valueint = INT_MIN;
+    } else {
+        item->valueint = (int)num;
+    }
+}
+
+cJSON *cJSON_CreateNumber(double num)
+{
+    cJSON *item = new_item(cJSON_Number);
+
+    if (item) {
+        set_number(item, num);
+    }
+    return item;
+}
+
+static cJSON *create_text(int type, const char *text)
+{
+    cJSON *item = new_item(type);
+
+    if (item) {
+        item->valuestring = copy_string(text);
+        if (!item->valuestring) {
+            cJSON_Delete(item);
+            return NULL;
+        }
+    }
+    return item;
+}
+
+cJSON *cJSON_CreateString(const char *string) { return create_text(cJSON_String, string); }
+cJSON *cJSON_CreateRaw(const char *raw) { return create_text(cJSON_Raw, raw); }
+
+cJSON *cJSON_CreateStringReference(const char *string)
+{
+    cJSON *item = new_item(cJSON_String | cJSON_IsReference);
+
+    if (item) {
+        item->valuestring = (char *)string;
+    }
+    return item;
+}
+
+static void append(cJSON *parent, cJSON *item)
+{
+    cJSON *child = parent->child;
+
+    if (child == NULL) {
+        parent->child = item;
+        item->prev = item;
+        item->next = NULL;
+    } else {
+        /* the first child's prev is the last child */
+        cJSON *last = child->prev;
+        last->next = item;
+        item->prev = last;
+        item->next = NULL;
+        child->prev = item;
+    }
+}
+
+cJSON *cJSON_CreateStringArray(const char *const *strings, int count)
+{
+    cJSON *array = cJSON_CreateArray();
+    int i;
+
+    for (i = 0; array && i < count; i++) {
+        cJSON *item = cJSON_CreateString(strings[i]);
+        if (!item) {
+            cJSON_Delete(array);
+            return NULL;
+        }
+        append(array, item);
+    }
+    return array;
+}
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    if (array == NULL || item == NULL || array == item) {
+        return 0;
+    }
+    append(array, item);
+    return 1;
+}
+
+static cJSON_bool add_to_object(cJSON *object, const char *string, cJSON *item, cJSON_bool constant)
+{
+    char *key;
+
+    if (object == NULL || string == NULL || item == NULL || object == item) {
+        return 0;
+    }
+
+    if (constant) {
+        key = (char *)string;
+    } else {
+        key = copy_string(string);
+        if (!key) {
+            return 0;
+        }
+    }
+
+    if (!(item->type & cJSON_StringIsConst) && item->string) {
+        cjson_free(item->string);
+    }
+    item->string = key;
+    item->type = constant ? (item->type | cJSON_StringIsConst) : (item->type & ~cJSON_StringIsConst);
+
+    append(object, item);
+    return 1;
+}
+
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
+{
+    return add_to_object(object, string, item, 0);
+}
+
+cJSON_bool cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
+{
+    return add_to_object(object, string, item, 1);
+}
+
+cJSON *cJSON_AddNullToObject(cJSON * const object, const char * const name)
+{
+    cJSON *item = cJSON_CreateNull();
+
+    if (add_to_object(object, name, item, 0)) {
+        return item;
+    }
+    cJSON_Delete(item);
+    return NULL;
+}
+
+/* lookup */
+
+int cJSON_GetArraySize(const cJSON *array)
+{
+    const cJSON *child;
+    int size = 0;
+
+    if (array == NULL) {
+        return 0;
+    }
+    for (child = array->child; child; child = child->next) {
+        size++;
+    }
+    return size;
+}
+
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index)
+{
+    cJSON *child;
+
+    if (array == NULL || index < 0) {
+        return NULL;
+    }
+    for (child = array->child; child && index > 0; child = child->next) {
+        index--;
+    }
+    return child;
+}
+
+static int case_insensitive_strcmp(const unsigned char *a, const unsigned char *b)
+{
+    for (; tolower(*a) == tolower(*b); a++, b++) {
+        if (*a == '\0') {
+            return 0;
+        }
+    }
+    return tolower(*a) - tolower(*b);
+}
+
+static cJSON *get_object_item(const cJSON *object, const char *name, cJSON_bool case_sensitive)
+{
+    cJSON *child;
+
+    if (object == NULL || name == NULL) {
+        return NULL;
+    }
+    for (child = object->child; child; child = child->next) {
+        if (child->string == NULL) {
+            continue;
+        }
+        if (case_sensitive ? strcmp(name, child->string) == 0
+                           : case_insensitive_strcmp((const unsigned char *)name, (const unsigned char *)child->string) == 0) {
+            return child;
+        }
+    }
+    return NULL;
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, 0);
+}
+
+cJSON *cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string)
+{
+    return get_object_item(object, string, 1);
+}
+
+/* editing */
+
+static cJSON *detach(cJSON *parent, cJSON *item)
+{
+    if (item != parent->child) {
+        item->prev->next = item->next;
+    }
+    if (item->next) {
+        item->next->prev = item->prev;
+    }
+
+    if (item == parent->child) {
+        parent->child = item->next;
+    } else if (item->next == NULL) {
+        parent->child->prev = item->prev;
+    }
+
+    item->prev = NULL;
+    item->next = NULL;
+    return item;
+}
+
+cJSON_bool cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object, const char *string)
+{
+    cJSON *item = get_object_item(object, string, 1);
+
+    if (item == NULL) {
+        return 0;
+    }
+    cJSON_Delete(detach(object, item));
+    return 1;
+}
+
+cJSON_bool cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON *replacement)
+{
+    if (parent == NULL || parent->child == NULL || item == NULL || replacement == NULL) {
+        return 0;
+    }
+    if (replacement == item) {
+        return 1;
+    }
+
+    replacement->next = item->next;
+    replacement->prev = item->prev;
+
+    if (replacement->next) {
+        replacement->next->prev = replacement;
+    }
+    if (parent->child == item) {
+        if (parent->child->prev == parent->child) {
+            replacement->prev = replacement;
+        }
+        parent->child = replacement;
+    } else {
+        if (replacement->prev) {
+            replacement->prev->next = replacement;
+        }
+        if (replacement->next == NULL) {
+            parent->child->prev = replacement;
+        }
+    }
+
+    item->next = NULL;
+    item->prev = NULL;
+    cJSON_Delete(item);
+    return 1;
+}
+
+cJSON_bool cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object, const char *string, cJSON *newitem)
+{
+    if (newitem == NULL || string == NULL) {
+        return 0;
+    }
+
+    if (!(newitem->type & cJSON_StringIsConst) && newitem->string) {
+        cjson_free(newitem->string);
+    }
+    newitem->string = copy_string(string);
+    newitem->type &= ~cJSON_StringIsConst;
+
+    return cJSON_ReplaceItemViaPointer(object, get_object_item(object, string, 1), newitem);
+}
+
+cJSON *cJSON_Duplicate(const cJSON *item, cJSON_bool recurse)
+{
+    cJSON *copy;
+    cJSON *child;
+
+    if (item == NULL) {
+        return NULL;
+    }
+
+    copy = new_item(item->type & ~cJSON_IsReference);
+    if (copy == NULL) {
+        return NULL;
+    }
+    copy->valueint = item->valueint;
+    copy->valuedouble = item->valuedouble;
+
+    if (item->valuestring) {
+        copy->valuestring = copy_string(item->valuestring);
+        if (!copy->valuestring) {
+            goto fail;
+        }
+    }
+    if (item->string) {
+        /* like cJSON, a constant key is shared, not copied */
+        copy->string = (item->type & cJSON_StringIsConst) ? item->string : copy_string(item->string);
+        if (!copy->string) {
+            goto fail;
+        }
+    }
+
+    if (!recurse) {
+        return copy;
+    }
+
+    for (child = item->child; child; child = child->next) {
+        cJSON *c = cJSON_Duplicate(child, 1);
+        if (c == NULL) {
+            goto fail;
+        }
+        append(copy, c);
+    }
+    return copy;
+
+fail:
+    cJSON_Delete(copy);
+    return NULL;
+}
+
+static cJSON_bool compare_double(double a, double b)
+{
+    double maxVal = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    return fabs(a - b) <= maxVal * DBL_EPSILON;
+}
+
+cJSON_bool cJSON_Compare(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive)
+{
+    const cJSON *ea;
+    const cJSON *eb;
+
+    if (a == NULL || b == NULL || (a->type & 0xFF) != (b->type & 0xFF) || cJSON_IsInvalid(a)) {
+        return 0;
+    }
+    if (a == b) {
+        return 1;
+    }
+
+    switch (a->type & 0xFF) {
+        case cJSON_False:
+        case cJSON_True:
+        case cJSON_NULL:
+            return 1;
+
+        case cJSON_Number:
+            return compare_double(a->valuedouble, b->valuedouble);
+
+        case cJSON_String:
+        case cJSON_Raw:
+            return a->valuestring && b->valuestring && strcmp(a->valuestring, b->valuestring) == 0;
+
+        case cJSON_Array:
+            for (ea = a->child, eb = b->child; ea && eb; ea = ea->next, eb = eb->next) {
+                if (!cJSON_Compare(ea, eb, case_sensitive)) {
+                    return 0;
+                }
+            }
+            return ea == eb;
+
+        case cJSON_Object:
+            for (ea = a->child; ea; ea = ea->next) {
+                eb = get_object_item(b, ea->string, case_sensitive);
+                if (eb == NULL || !cJSON_Compare(ea, eb, case_sensitive)) {
+                    return 0;
+                }
+            }
+            for (eb = b->child; eb; eb = eb->next) {
+                if (get_object_item(a, eb->string, case_sensitive) == NULL) {
+                    return 0;
+                }
+            }
+            return 1;
+    }
+    return 0;
+}
+
+/* parsing, as lenient as cJSON's: trailing content is ignored */
+
+typedef struct {
+    const char *p;
+    int depth;
+} parser;
+
+static cJSON *parse_value(parser *ps);
+
+static void skip_space(parser *ps)
+{
+    while (*ps->p && (unsigned char)*ps->p <= 32) {
+        ps->p++;
+    }
+}
+
+static int parse_hex4(const char *p, unsigned int *code)
+{
+    int i;
+
+    *code = 0;
+    for (i = 0; i < 4; i++) {
+        char c = p[i];
+        *code <<= 4;
+        if (c >= '0' && c <= '9') {
+            *code |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            *code |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            *code |= c - 'A' + 10;
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static char *put_utf8(char *out, unsigned long code)
+{
+    if (code < 0x80) {
+        *out++ = (char)code;
+    } else if (code < 0x800) {
+        *out++ = (char)(0xC0 | (code >> 6));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        *out++ = (char)(0xE0 | (code >> 12));
+        *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    } else {
+        *out++ = (char)(0xF0 | (code >> 18));
+        *out++ = (char)(0x80 | ((code >> 12) & 0x3F));
+        *out++ = (char)(0x80 | ((code >> 6) & 0x3F));
+        *out++ = (char)(0x80 | (code & 0x3F));
+    }
+    return out;
+}
+
+/* p is on the opening quote */
+static char *parse_string(parser *ps)
+{
+    const char *end = ps->p + 1;
+    char *text;
+    char *out;
+    const char *in;
+
+    while (*end && *end != '"') {
+        if (*end == '\\' && end[1]) {
+            end++;
+        }
+        end++;
+    }
+    if (*end != '"') {
+        return NULL;
+    }
+
+    text = (char *)cjson_malloc(end - ps->p);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    out = text;
+    for (in = ps->p + 1; in < end; ) {
+        if (*in != '\\') {
+            *out++ = *in++;
+            continue;
+        }
+        in++;
+        switch (*in) {
+            case 'b': *out++ = '\b'; in++; break;
+            case 'f': *out++ = '\f'; in++; break;
+            case 'n': *out++ = '\n'; in++; break;
+            case 'r': *out++ = '\r'; in++; break;
+            case 't': *out++ = '\t'; in++; break;
+            case '"':
+            case '\\':
+            case '/': *out++ = *in++; break;
+            case 'u': {
+                unsigned int code;
+                unsigned int low;
+
+                if (end - in < 5 || !parse_hex4(in + 1, &code) || (code >= 0xDC00 && code <= 0xDFFF)) {
+                    goto fail;
+                }
+                in += 5;
+                if (code >= 0xD800 && code <= 0xDBFF) {
+                    if (end - in < 6 || in[0] != '\\' || in[1] != 'u' || !parse_hex4(in + 2, &low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        goto fail;
+                    }
+                    in += 6;
+                    out = put_utf8(out, 0x10000 + (((unsigned long)code - 0xD800) << 10) + (low - 0xDC00));
+                } else {
+                    out = put_utf8(out, code);
+                }
+                break;
+            }
+            default:
+                goto fail;
+        }
+    }
+    *out = '\0';
+    ps->p = end + 1;
+    return text;
+
+fail:
+    cjson_free(text);
+    return NULL;
+}
+
+static cJSON *parse_number(parser *ps)
+{
+    char buffer[64];
+    size_t length = 0;
+    char *end;
+    double number;
+
+    while (length < sizeof(buffer) - 1 &&
+           (isdigit((unsigned char)ps->p[length]) || strchr("+-eE.", ps->p[length]) != NULL) && ps->p[length]) {
+        buffer[length] = ps->p[length];
+        length++;
+    }
+    buffer[length] = '\0';
+
+    number = strtod(buffer, &end);
+    if (end == buffer) {
+        return NULL;
+    }
+    ps->p += end - buffer;
+    return cJSON_CreateNumber(number);
+}
+
+static cJSON *parse_container(parser *ps, int type)
+{
+    char close = type == cJSON_Object ? '}' : ']';
+    cJSON *container;
+
+    if (++ps->depth > CJSON_NESTING_LIMIT) {
+        return NULL;
+    }
+    container = new_item(type);
+    if (container == NULL) {
+        return NULL;
+    }
+
+    ps->p++;
+    skip_space(ps);
+    if (*ps->p == close) {
+        ps->p++;
+        ps->depth--;
+        return container;
+    }
+
+    for (;;) {
+        char *key = NULL;
+        cJSON *item;
+
+        skip_space(ps);
+        if (type == cJSON_Object) {
+            if (*ps->p != '"' || (key = parse_string(ps)) == NULL) {
+                goto fail;
+            }
+            skip_space(ps);
+            if (*ps->p != ':') {
+                cjson_free(key);
+                goto fail;
+            }
+            ps->p++;
+        }
+
+        item = parse_value(ps);
+        if (item == NULL) {
+            if (key) {
+                cjson_free(key);
+            }
+            goto fail;
+        }
+        item->string = key;
+        append(container, item);
+
+        skip_space(ps);
+        if (*ps->p == close) {
+            ps->p++;
+            ps->depth--;
+            return container;
+        }
+        if (*ps->p != ',') {
+            goto fail;
+        }
+        ps->p++;
+    }
+
+fail:
+    cJSON_Delete(container);
+    return NULL;
+}
+
+static cJSON *parse_value(parser *ps)
+{
+    skip_space(ps);
+
+    if (strncmp(ps->p, "null", 4) == 0) {
+        ps->p += 4;
+        return cJSON_CreateNull();
+    }
+    if (strncmp(ps->p, "false", 5) == 0) {
+        ps->p += 5;
+        return cJSON_CreateFalse();
+    }
+    if (strncmp(ps->p, "true", 4) == 0) {
+        ps->p += 4;
+        return cJSON_CreateTrue();
+    }
+
+    switch (*ps->p) {
+        case '"': {
+            cJSON *item = new_item(cJSON_String);
+            if (item && (item->valuestring = parse_string(ps)) == NULL) {
+                cJSON_Delete(item);
+                return NULL;
+            }
+            return item;
+        }
+        case '[':
+            return parse_container(ps, cJSON_Array);
+        case '{':
+            return parse_container(ps, cJSON_Object);
+        case '-':
+            return parse_number(ps);
+    }
+    if (*ps->p >= '0' && *ps->p <= '9') {
+        return parse_number(ps);
+    }
+    return NULL;
+}
+
+cJSON *cJSON_Parse(const char *value)
+{
+    parser ps;
+
+    if (value == NULL) {
+        return NULL;
+    }
+    ps.p = value;
+    ps.depth = 0;
+    return parse_value(&ps);
+}
+
+/* printing */
+
+typedef struct {
+    char *buffer;
+    size_t length;
+    size_t size;
+    int failed;
+} printer;
+
+static void put(printer *pr, const char *s, size_t n)
+{
+    if (pr->failed) {
+        return;
+    }
+    if (pr->length + n + 1 > pr->size) {
+        size_t size = (pr->length + n + 1) * 2;
+        char *buffer = (char *)cjson_malloc(size);
+        if (buffer == NULL) {
+            pr->failed = 1;
+            return;
+        }
+        if (pr->buffer) {
+            memcpy(buffer, pr->buffer, pr->length);
+            cjson_free(pr->buffer);
+        }
+        pr->buffer = buffer;
+        pr->size = size;
+    }
+    memcpy(pr->buffer + pr->length, s, n);
+    pr->length += n;
+    pr->buffer[pr->length] = '\0';
+}
+
+static void put_s(printer *pr, const char *s)
+{
+    put(pr, s, strlen(s));
+}
+
+/* print_number() of cJSON 1.7.15 */
+static void print_number(printer *pr, const cJSON *item)
+{
+    char number[26];
+    double d = item->valuedouble;
+    double test = 0.0;
+
+    if (isnan(d) || isinf(d)) {
+        strcpy(number, "null");
+    } else if (d == (double)item->valueint) {
+        sprintf(number, "%d", item->valueint);
+    } else {
+        sprintf(number, "%1.15g", d);
+        if (sscanf(number, "%lg", &test) != 1 || !compare_double(test, d)) {
+            sprintf(number, "%1.17g", d);
+        }
+    }
+    put_s(pr, number);
+}
+
+static void print_string(printer *pr, const char *s)
+{
+    put(pr, "\"", 1);
+    for (; s && *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        char escape[8];
+
+        switch (c) {
+            case '"': put_s(pr, "\\\""); break;
+            case '\\': put_s(pr, "\\\\"); break;
+            case '\b': put_s(pr, "\\b"); break;
+            case '\f': put_s(pr, "\\f"); break;
+            case '\n': put_s(pr, "\\n"); break;
+            case '\r': put_s(pr, "\\r"); break;
+            case '\t': put_s(pr, "\\t"); break;
+            default:
+                if (c < 32) {
+                    sprintf(escape, "\\u%04x", c);
+                    put_s(pr, escape);
+                } else {
+                    put(pr, (const char *)&c, 1);
+                }
+        }
+    }
+    put(pr, "\"", 1);
+}
+
+static void print_value(printer *pr, const cJSON *item)
+{
+    const cJSON *child;
+
+    switch (item->type & 0xFF) {
+        case cJSON_NULL: put_s(pr, "null"); return;
+        case cJSON_False: put_s(pr, "false"); return;
+        case cJSON_True: put_s(pr, "true"); return;
+        case cJSON_Number: print_number(pr, item); return;
+        case cJSON_Raw:
+            if (item->valuestring == NULL) {
+                pr->failed = 1;
+                return;
+            }
+            put_s(pr, item->valuestring);
+            return;
+        case cJSON_String: print_string(pr, item->valuestring); return;
+
+        case cJSON_Array:
+            put(pr, "[", 1);
+            for (child = item->child; child; child = child->next) {
+                print_value(pr, child);
+                if (child->next) {
+                    put(pr, ",", 1);
+                }
+            }
+            put(pr, "]", 1);
+            return;
+
+        case cJSON_Object:
+            put(pr, "{", 1);
+            for (child = item->child; child; child = child->next) {
+                print_string(pr, child->string);
+                put(pr, ":", 1);
+                print_value(pr, child);
+                if (child->next) {
+                    put(pr, ",", 1);
+                }
+            }
+            put(pr, "}", 1);
+            return;
+    }
+    pr->failed = 1;
+}
+
+char *cJSON_PrintUnformatted(const cJSON *item)
+{
+    printer pr = {NULL, 0, 0, 0};
+
+    if (item == NULL) {
+        return NULL;
+    }
+    print_value(&pr, item);
+    if (pr.failed) {
+        if (pr.buffer) {
+            cjson_free(pr.buffer);
+        }
+        return NULL;
+    }
+    return pr.buffer;
+}
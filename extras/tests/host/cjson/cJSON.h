@@ -0,0 +1,106 @@
+/*
+  Host stand-in for the subset of cJSON (https://github.com/DaveGamble/cJSON)
+  that the Arduino_JSON library calls.  The library's copy of cJSON is not
+  part of this tree; point CJSON_DIR at it to test against the real thing.
+
+  Node layout, type flags, reference and constant-key ownership rules and
+  the number and string output follow cJSON 1.7.
+*/
+
+#ifndef cJSON__h
+#define cJSON__h
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#define cJSON_Invalid (0)
+#define cJSON_False  (1 << 0)
+#define cJSON_True   (1 << 1)
+#define cJSON_NULL   (1 << 2)
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Array  (1 << 5)
+#define cJSON_Object (1 << 6)
+#define cJSON_Raw    (1 << 7)
+
+#define cJSON_IsReference 256
+#define cJSON_StringIsConst 512
+
+#define CJSON_NESTING_LIMIT 1000
+
+typedef int cJSON_bool;
+
+typedef struct cJSON
+{
+    struct cJSON *next;
+    struct cJSON *prev;
+    struct cJSON *child;
+    int type;
+    char *valuestring;
+    int valueint;
+    double valuedouble;
+    char *string;
+} cJSON;
+
+typedef struct cJSON_Hooks
+{
+    void *(*malloc_fn)(size_t sz);
+    void (*free_fn)(void *ptr);
+} cJSON_Hooks;
+
+void cJSON_InitHooks(cJSON_Hooks* hooks);
+
+cJSON *cJSON_Parse(const char *value);
+char *cJSON_PrintUnformatted(const cJSON *item);
+void cJSON_Delete(cJSON *item);
+void *cJSON_malloc(size_t size);
+void cJSON_free(void *object);
+
+int cJSON_GetArraySize(const cJSON *array);
+cJSON *cJSON_GetArrayItem(const cJSON *array, int index);
+cJSON *cJSON_GetObjectItem(const cJSON * const object, const char * const string);
+cJSON *cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
+
+cJSON_bool cJSON_IsInvalid(const cJSON * const item);
+cJSON_bool cJSON_IsFalse(const cJSON * const item);
+cJSON_bool cJSON_IsTrue(const cJSON * const item);
+cJSON_bool cJSON_IsBool(const cJSON * const item);
+cJSON_bool cJSON_IsNull(const cJSON * const item);
+cJSON_bool cJSON_IsNumber(const cJSON * const item);
+cJSON_bool cJSON_IsString(const cJSON * const item);
+cJSON_bool cJSON_IsArray(const cJSON * const item);
+cJSON_bool cJSON_IsObject(const cJSON * const item);
+cJSON_bool cJSON_IsRaw(const cJSON * const item);
+
+cJSON *cJSON_CreateNull(void);
+cJSON *cJSON_CreateTrue(void);
+cJSON *cJSON_CreateFalse(void);
+cJSON *cJSON_CreateNumber(double num);
+cJSON *cJSON_CreateString(const char *string);
+cJSON *cJSON_CreateRaw(const char *raw);
+cJSON *cJSON_CreateArray(void);
+cJSON *cJSON_CreateObject(void);
+cJSON *cJSON_CreateStringReference(const char *string);
+cJSON *cJSON_CreateStringArray(const char *const *strings, int count);
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item);
+cJSON_bool cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item);
+cJSON_bool cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item);
+cJSON *cJSON_AddNullToObject(cJSON * const object, const char * const name);
+
+cJSON_bool cJSON_DeleteItemFromObjectCaseSensitive(cJSON *object, const char *string);
+cJSON_bool cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON * const item, cJSON * replacement);
+cJSON_bool cJSON_ReplaceItemInObjectCaseSensitive(cJSON *object, const char *string, cJSON *newitem);
+
+cJSON *cJSON_Duplicate(const cJSON *item, cJSON_bool recurse);
+cJSON_bool cJSON_Compare(const cJSON * const a, const cJSON * const b, const cJSON_bool case_sensitive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
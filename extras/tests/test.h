@@ -0,0 +1,80 @@
+// Minimal checks for the host tests.  Each test program runs its TEST()s
+// in order and exits non-zero if any CHECK failed.
+
+#ifndef test_h
+#define test_h
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "ArduinoHost.h"
+
+typedef void (*TestFn)(void);
+
+struct TestCase {
+  const char *name;
+  TestFn fn;
+  TestCase *next;
+};
+
+extern TestCase *testHead;
+extern TestCase **testTail;
+extern int testFailures;
+
+struct TestRegistrar {
+  TestRegistrar(TestCase *test) {
+    *testTail = test;
+    testTail = &test->next;
+  }
+};
+
+#define TEST(name)                                                             \
+  static void test_##name();                                                   \
+  static TestCase testCase_##name = {#name, test_##name, NULL};                \
+  static TestRegistrar testRegistrar_##name(&testCase_##name);                 \
+  static void test_##name()
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);          \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(expected, actual)                                             \
+  do {                                                                         \
+    long long e_ = (long long)(expected), a_ = (long long)(actual);            \
+    if (e_ != a_) {                                                            \
+      printf("%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__,     \
+             #expected, #actual, e_, a_);                                      \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+// a function, so temporaries such as String(...).c_str() outlive the check
+inline void checkStr(const char *e, const char *a, const char *file, int line,
+                     const char *expected, const char *actual)
+{
+  if (a == NULL || strcmp(e, a) != 0) {
+    printf("%s:%d: %s == %s failed: \"%s\" != \"%s\"\n", file, line,
+           expected, actual, e, a ? a : "(null)");
+    testFailures++;
+  }
+}
+
+#define CHECK_STR(expected, actual)                                            \
+  checkStr((expected), (actual), __FILE__, __LINE__, #expected, #actual)
+
+#define CHECK_NEAR(expected, actual, tolerance)                                \
+  do {                                                                         \
+    double e_ = (expected), a_ = (actual);                                     \
+    if (!(fabs(e_ - a_) <= (tolerance))) {                                     \
+      printf("%s:%d: %s ~ %s failed: %g != %g\n", __FILE__, __LINE__,         \
+             #expected, #actual, e_, a_);                                      \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+#endif
@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+
+#include <DecimalCodec.h>
+
+#include "test.h"
+
+// collects what is printed to it
+class StringPrint : public Print {
+public:
+  virtual size_t write(uint8_t c) { text += (char)c; return 1; }
+  using Print::write;
+  std::string text;
+};
+
+TEST(fixed_round_trip)
+{
+  char buffer[DECIMAL_BUFFER_SIZE];
+
+  for (int32_t v = -50000; v <= 150000; v++) {
+    decimalFormatFixed(buffer, v, 2);
+
+    int32_t back = 0;
+    const char *end;
+    CHECK(decimalParseFixed(buffer, 2, back, &end));
+    CHECK_EQ(v, back);
+    CHECK(*end == '\0');
+
+    // the double path gives the correctly rounded value of the same text
+    double d = decimalParse(buffer, &end);
+    CHECK(d == strtod(buffer, NULL));
+    CHECK(*end == '\0');
+
+    char again[DECIMAL_BUFFER_SIZE];
+    decimalFormat(again, d, 2);
+    CHECK_STR(buffer, again);
+  }
+}
+
+TEST(format_fixed)
+{
+  char buffer[DECIMAL_BUFFER_SIZE];
+
+  decimalFormatFixed(buffer, 2346, 2);
+  CHECK_STR("23.46", buffer);
+  decimalFormatFixed(buffer, -5, 2);
+  CHECK_STR("-0.05", buffer);
+  decimalFormatFixed(buffer, 0, 0);
+  CHECK_STR("0", buffer);
+  decimalFormatFixed(buffer, 7, 3);
+  CHECK_STR("0.007", buffer);
+  decimalFormatFixed(buffer, -2147483647 - 1, 0);
+  CHECK_STR("-2147483648", buffer);
+  decimalFormatFixed(buffer, 2147483647, 9);
+  CHECK_STR("2.147483647", buffer);
+}
+
+TEST(parse_fixed_rounding)
+{
+  int32_t v = 0;
+
+  CHECK(decimalParseFixed("23.456", 2, v));
+  CHECK_EQ(2346, v);
+  CHECK(decimalParseFixed("23.454", 2, v));
+  CHECK_EQ(2345, v);
+  CHECK(decimalParseFixed("-23.455", 2, v));
+  CHECK_EQ(-2346, v);
+  CHECK(decimalParseFixed("+7", 1, v));
+  CHECK_EQ(70, v);
+  CHECK(decimalParseFixed(".5", 0, v));
+  CHECK_EQ(1, v);
+
+  const char *end;
+  CHECK(!decimalParseFixed("abc", 2, v, &end));
+  CHECK_STR("abc", end);
+  CHECK(!decimalParseFixed("-", 2, v, &end));
+  CHECK_STR("-", end);
+
+  // 2^31 - 1 is the largest magnitude
+  CHECK(decimalParseFixed("21474836.47", 2, v));
+  CHECK_EQ(2147483647, v);
+  CHECK(!decimalParseFixed("21474836.48", 2, v));
+  CHECK(!decimalParseFixed("99999999999", 0, v));
+}
+
+TEST(parse_matches_strtod)
+{
+  static const char *samples[] = {
+    "0", "-0", "1", "298.48", "-84.388", "2.5e-3", "1e22", "1e23", "123456789012345678",
+    "0.1", "0.30000000000000004", "9007199254740993", "4.9e-324", "1.7976931348623157e308",
+    "1e-400", "1e400", "3.14159265358979323846264338327950288", "100000000000000000000000",
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    const char *end;
+    double d = decimalParse(samples[i], &end);
+    double expected = strtod(samples[i], NULL);
+
+    CHECK(d == expected || (isinf(d) && isinf(expected)));
+    CHECK(*end == '\0');
+  }
+
+  // random mantissas and exponents around the fast path's limits
+  srand(1);
+  for (int i = 0; i < 100000; i++) {
+    char text[48];
+    long long mantissa = ((long long)rand() << 31 | rand()) % 100000000000000000LL;
+    int exponent = rand() % 60 - 30;
+
+    snprintf(text, sizeof(text), "%s%lld.%de%d", (i & 1) ? "-" : "", mantissa, rand() % 1000, exponent);
+    CHECK(decimalParse(text) == strtod(text, NULL));
+  }
+}
+
+TEST(parse_loose_and_end)
+{
+  const char *end;
+
+  CHECK(decimalParse("+1.5", &end) == 1.5);
+  CHECK(decimalParse(".5", &end) == 0.5);
+  CHECK(decimalParse("1.", &end) == 1.0);
+  CHECK(decimalParse("007", &end) == 7.0);
+
+  // an exponent without digits is not part of the number
+  CHECK(decimalParse("12e", &end) == 12.0);
+  CHECK_STR("e", end);
+  CHECK(decimalParse("12e+x", &end) == 12.0);
+  CHECK_STR("e+x", end);
+
+  CHECK(decimalParse("23.5 C", &end) == 23.5);
+  CHECK_STR(" C", end);
+
+  CHECK(decimalParse("-", &end) == 0);
+  CHECK_STR("-", end);
+  CHECK(decimalParse("x", &end) == 0);
+  CHECK_STR("x", end);
+  CHECK(decimalParse("", &end) == 0);
+}
+
+TEST(parse_strict)
+{
+  static const char *good[] = {"0", "-0", "1", "-1", "0.5", "-0.5", "10", "1e5", "1E+5", "1.5e-5", "0e0"};
+  static const char *bad[] = {"", "-", "+1", ".5", "-.5", "1.", "01", "-01", "00", "1e", "1e+", "1.2.3", "inf", "nan"};
+
+  for (size_t i = 0; i < sizeof(good) / sizeof(*good); i++) {
+    const char *end;
+    double d = decimalParse(good[i], &end, true);
+    CHECK(d == strtod(good[i], NULL));
+    CHECK(*end == '\0');
+  }
+  for (size_t i = 0; i < sizeof(bad) / sizeof(*bad); i++) {
+    const char *end;
+    CHECK(decimalParse(bad[i], &end, true) == 0);
+    CHECK(end == bad[i]);
+  }
+
+  // a number may be followed by anything that can't continue it
+  const char *end;
+  CHECK(decimalParse("12,", &end, true) == 12);
+  CHECK_STR(",", end);
+  CHECK(decimalParse("-3]", &end, true) == -3);
+  CHECK_STR("]", end);
+  CHECK(decimalParse("0x10", &end, true) == 0);
+  CHECK_STR("x10", end);
+}
+
+TEST(format_matches_print)
+{
+  static const double samples[] = {
+    0, 1, -1, 0.5, 0.005, -0.005, -0.001, 23.456, -84.388, 298.48, 123456.891, 0.125, 99.995, -2.5,
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+      StringPrint expected;
+      StringPrint actual;
+
+      expected.print(samples[i], decimals);
+      CHECK_EQ(expected.text.size(), decimalPrint(actual, samples[i], decimals));
+      CHECK_STR(expected.text.c_str(), actual.text.c_str());
+    }
+  }
+
+  char buffer[DECIMAL_BUFFER_SIZE];
+  decimalFormat(buffer, NAN, 2);
+  CHECK_STR("nan", buffer);
+  decimalFormat(buffer, -INFINITY, 2);
+  CHECK_STR("-inf", buffer);
+  // too large for 32-bit fixed point, unlike print()
+  decimalFormat(buffer, 3e12, 2);
+  CHECK_STR("3.00e+12", buffer);
+}
+
+// Not a check: time against the C library, e.g. after changing the codec.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  static char texts[2000][DECIMAL_BUFFER_SIZE];
+  volatile double sink = 0;
+  const int rounds = 50;
+
+  for (int i = 0; i < 2000; i++) {
+    decimalFormatFixed(texts[i], i * 101 - 50000, 2);
+  }
+
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < 2000; i++) {
+      sink = sink + decimalParse(texts[i]);
+    }
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < 2000; i++) {
+      sink = sink + strtod(texts[i], NULL);
+    }
+  }
+  Clock::time_point t2 = Clock::now();
+
+  char buffer[DECIMAL_BUFFER_SIZE];
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < 2000; i++) {
+      sink = sink + decimalFormat(buffer, i * 1.01 - 500, 2);
+    }
+  }
+  Clock::time_point t3 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < 2000; i++) {
+      sink = sink + snprintf(buffer, sizeof(buffer), "%.2f", i * 1.01 - 500);
+    }
+  }
+  Clock::time_point t4 = Clock::now();
+
+  double n = rounds * 2000.0;
+  printf("parse %.1f ns (strtod %.1f ns), format %.1f ns (snprintf %.1f ns)\n",
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / n,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / n,
+         std::chrono::duration<double, std::nano>(t3 - t2).count() / n,
+         std::chrono::duration<double, std::nano>(t4 - t3).count() / n);
+}
@@ -0,0 +1,212 @@
+#include <stdlib.h>
+
+#include <DHT.h>
+
+#include "DHTSensor.h"
+#include "test.h"
+
+#define ISR_PIN 21    // external interrupt 2 on the Mega: edges are timestamped
+#define POLLED_PIN 41 // no interrupt: the frame is timed by polling
+
+// startRead() and poll() until the read finishes; the longest poll() call
+// in us goes to longestPoll
+static bool pollRead(DHT& dht, host_time_t* longestPoll = NULL)
+{
+  host_time_t longest = 0;
+
+  CHECK(dht.startRead(true));
+  for (int i = 0; i < 1000; i++) {
+    host_time_t before = hostNow();
+    bool done = dht.poll();
+    if (hostNow() - before > longest) {
+      longest = hostNow() - before;
+    }
+    if (done) {
+      if (longestPoll) {
+        *longestPoll = longest;
+      }
+      return dht.sample().valid;
+    }
+    hostAdvance(100);
+  }
+
+  CHECK(!"poll() never finished");
+  return false;
+}
+
+TEST(blocking_read)
+{
+  DHTSensor sensor(POLLED_PIN);
+  DHT dht(POLLED_PIN, DHT11);
+
+  sensor.setDHT11(58, 0, 23, 4);
+  dht.begin();
+  CHECK(dht.read(true));
+  CHECK_EQ(1, sensor.frames);
+  CHECK_NEAR(58.0, dht.readHumidity(), 1e-4);
+  CHECK_NEAR(23.4, dht.readTemperature(), 1e-4);
+  CHECK_NEAR(74.12, dht.readTemperature(true), 1e-3);
+
+  // within two seconds the last reading is returned without a new frame
+  CHECK(dht.read());
+  CHECK_EQ(1, sensor.frames);
+  CHECK_EQ(1, dht.stats().reads);
+}
+
+// every frame decodes to its values on both paths, and at the ends of
+// the sensor clock's tolerance
+TEST(random_frames)
+{
+  static const uint8_t pins[] = { ISR_PIN, POLLED_PIN };
+  static const unsigned int clocks[] = { 100, 80, 120 };
+
+  srand(3);
+  for (size_t p = 0; p < sizeof(pins) / sizeof(*pins); p++) {
+    for (size_t c = 0; c < sizeof(clocks) / sizeof(*clocks); c++) {
+      hostReset();
+      DHTSensor sensor(pins[p]);
+      DHT dht(pins[p], DHT22);
+
+      sensor.minStartLow = 1000;
+      sensor.clockPercent = clocks[c];
+      dht.begin();
+
+      for (int i = 0; i < 100; i++) {
+        uint16_t humidity10 = rand() % 1001;
+        int16_t temperature10 = rand() % 1201 - 400;
+
+        sensor.setDHT22(humidity10, temperature10);
+        if (!pollRead(dht)) {
+          printf("pin %d, clock %u%%: frame %u %d failed\n", pins[p], clocks[c], humidity10, temperature10);
+          testFailures++;
+          continue;
+        }
+        CHECK_NEAR(humidity10 / 10.0, dht.sample().humidity, 1e-3);
+        CHECK_NEAR(temperature10 / 10.0, dht.sample().temperature, 1e-3);
+      }
+      CHECK_EQ(100, dht.stats().reads);
+      CHECK_EQ(0, dht.stats().checksumErrors);
+    }
+  }
+}
+
+TEST(checksum)
+{
+  static const uint8_t pins[] = { ISR_PIN, POLLED_PIN };
+
+  for (size_t p = 0; p < sizeof(pins) / sizeof(*pins); p++) {
+    hostReset();
+    DHTSensor sensor(pins[p]);
+    DHT dht(pins[p], DHT11);
+
+    dht.begin();
+    sensor.setDHT11(40, 0, 21, 0);
+    CHECK(pollRead(dht));
+
+    sensor.setDHT11(90, 0, 30, 0);
+    sensor.corruptChecksum = true;
+    CHECK(!pollRead(dht));
+    CHECK(!pollRead(dht));
+    CHECK_EQ(2, dht.stats().checksumErrors);
+    CHECK_EQ(1, dht.stats().reads);
+
+    // the sample keeps the last good values and counts the failures
+    CHECK(!dht.sample().valid);
+    CHECK_EQ(2, dht.sample().failures);
+    CHECK_NEAR(40.0, dht.sample().humidity, 1e-4);
+    CHECK_NEAR(21.0, dht.sample().temperature, 1e-4);
+
+    sensor.corruptChecksum = false;
+    CHECK(pollRead(dht));
+    CHECK_EQ(0, dht.sample().failures);
+    CHECK_NEAR(90.0, dht.sample().humidity, 1e-4);
+  }
+}
+
+TEST(timeouts_are_told_apart)
+{
+  static const uint8_t pins[] = { ISR_PIN, POLLED_PIN };
+
+  for (size_t p = 0; p < sizeof(pins) / sizeof(*pins); p++) {
+    hostReset();
+    DHTSensor sensor(pins[p]);
+    DHT dht(pins[p], DHT11);
+
+    dht.begin();
+    sensor.setDHT11(50, 0, 25, 0);
+
+    sensor.reply = false;
+    CHECK(!pollRead(dht));
+    CHECK_EQ(1, dht.stats().startTimeouts);
+
+    sensor.reply = true;
+    sensor.bitsSent = 0;
+    CHECK(!pollRead(dht));
+    CHECK_EQ(1, dht.stats().preambleTimeouts);
+
+    sensor.bitsSent = 20;
+    CHECK(!pollRead(dht));
+    CHECK_EQ(1, dht.stats().bitTimeouts);
+
+    sensor.bitsSent = 40;
+    CHECK(pollRead(dht));
+    CHECK_EQ(1, dht.stats().reads);
+    CHECK_EQ(0, dht.stats().checksumErrors);
+
+    dht.resetStats();
+    CHECK_EQ(0, dht.stats().startTimeouts + dht.stats().preambleTimeouts + dht.stats().bitTimeouts);
+  }
+}
+
+TEST(poll_does_not_block_on_an_interrupt_pin)
+{
+  DHTSensor sensor(ISR_PIN);
+  DHT dht(ISR_PIN, DHT11);
+  host_time_t longest;
+
+  dht.begin();
+  sensor.setDHT11(45, 0, 19, 0);
+  CHECK(pollRead(dht, &longest));
+  CHECK(longest < 50);
+
+  // on a polled pin the frame (~5 ms) is timed inside one poll()
+  hostReset();
+  DHTSensor polledSensor(POLLED_PIN);
+  DHT polled(POLLED_PIN, DHT11);
+  polled.begin();
+  polledSensor.setDHT11(45, 0, 19, 0);
+  CHECK(pollRead(polled, &longest));
+  CHECK(longest > 3000 && longest < 8000);
+}
+
+// pullTime follows where in the release-to-reply window the sensor answers
+TEST(pull_time_tuning)
+{
+  DHTSensor sensor(POLLED_PIN);
+  DHT dht(POLLED_PIN, DHT11);
+
+  sensor.setDHT11(50, 0, 25, 0);
+  dht.begin();
+  CHECK_EQ(55, dht.pullUpTime());
+
+  // a slow reply (long cable) pushes it out in steps; the reads until it
+  // has caught up are lost
+  sensor.responseDelay = 75;
+  int good = 0;
+  for (int i = 0; i < 20; i++) {
+    good += pollRead(dht);
+  }
+  CHECK(good >= 15);
+  CHECK(pollRead(dht));
+  CHECK(dht.pullUpTime() >= 75 - DHT_PULL_STEP);
+  CHECK(dht.pullUpTime() <= DHT_PULL_MAX);
+
+  // a fast one, with most of the response pulse missed, pulls it back in
+  // until at least half of it is seen; no reads are lost on the way
+  sensor.responseDelay = 20;
+  for (int i = 0; i < 20; i++) {
+    CHECK(pollRead(dht));
+  }
+  CHECK(dht.pullUpTime() >= DHT_PULL_MIN);
+  CHECK(dht.pullUpTime() <= 20 + 80 / 2);
+}
@@ -0,0 +1,92 @@
+#include <chrono>
+
+#include <DHT.h>
+#include <DHTApparent.h>
+
+#include "test.h"
+
+// every 0.1 C and 0.1 %RH over the DHT11's range, against the formulas
+// the tables were made from, to the bounds in DHTApparent.cpp
+TEST(heat_index_against_the_formula)
+{
+  DHT dht(41, DHT11);
+  double worst = 0;
+  double worstSwitch = 0;
+
+  for (int16_t t = 0; t <= 500; t++) {
+    for (uint16_t h = 0; h <= 1000; h++) {
+      float expected = dht.computeHeatIndex(t / 10.0f, h / 10.0f, false);
+      double error = fabs(dhtHeatIndex10(t, h) / 10.0 - expected);
+
+      // where the formula switches to the Rothfusz regression
+      if (t >= 240 && t <= 275) {
+        worstSwitch = fmax(worstSwitch, error);
+      } else {
+        worst = fmax(worst, error);
+      }
+    }
+  }
+
+  printf("heat index: within %.2f C, %.2f C from 24 to 27.5 C\n", worst, worstSwitch);
+  CHECK(worst <= 0.6);
+  CHECK(worstSwitch <= 0.9);
+}
+
+TEST(dew_point_against_the_formula)
+{
+  double worst = 0;
+
+  for (int16_t t = 0; t <= 500; t++) {
+    for (uint16_t h = 100; h <= 1000; h++) {
+      double error = fabs(dhtDewPoint10(t, h) / 10.0 - dhtDewPointReference(t / 10.0f, h / 10.0f));
+      worst = fmax(worst, error);
+    }
+  }
+
+  printf("dew point: within %.2f C\n", worst);
+  CHECK(worst <= 0.35);
+
+  // saturated air is at its dew point
+  CHECK_EQ(0, dhtDewPoint10(0, 1000));
+  CHECK_EQ(253, dhtDewPoint10(253, 1000));
+  CHECK_NEAR(25.3, dhtDewPointReference(25.3f, 100.0f), 1e-4);
+}
+
+TEST(clamped_outside_the_tables)
+{
+  CHECK_EQ(dhtHeatIndex10(0, 500), dhtHeatIndex10(-100, 500));
+  CHECK_EQ(dhtHeatIndex10(500, 500), dhtHeatIndex10(600, 500));
+  CHECK_EQ(dhtHeatIndex10(300, 1000), dhtHeatIndex10(300, 1200));
+  CHECK_EQ(dhtDewPoint10(300, 100), dhtDewPoint10(300, 0));
+  CHECK_EQ(dhtDewPoint10(300, 1000), dhtDewPoint10(300, 1100));
+
+  // table points come back exactly
+  CHECK_EQ(-39, dhtHeatIndex10(0, 0));
+  CHECK_EQ(2062, dhtHeatIndex10(500, 1000));
+  CHECK_EQ(-281, dhtDewPoint10(0, 100));
+  CHECK_EQ(500, dhtDewPoint10(500, 1000));
+}
+
+// Not a check: the lookups against the float formulas on this machine.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  DHT dht(41, DHT11);
+  volatile float sink = 0;
+  const int n = 200000;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    sink = sink + dhtHeatIndex10(i % 500, i % 1000) + dhtDewPoint10(i % 500, 100 + i % 900);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    sink = sink + dht.computeHeatIndex((i % 500) / 10.0f, (i % 1000) / 10.0f, false) +
+           dhtDewPointReference((i % 500) / 10.0f, (100 + i % 900) / 10.0f);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  printf("tables %.1f ns, formulas %.1f ns per pair\n",
+         std::chrono::duration<double, std::nano>(t1 - t0).count() / n,
+         std::chrono::duration<double, std::nano>(t2 - t1).count() / n);
+}
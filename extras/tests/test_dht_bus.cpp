@@ -0,0 +1,127 @@
+#include <DHTBus.h>
+
+#include "DHTSensor.h"
+#include "test.h"
+
+// poll() every 100 us until a round completes; false after limitMs
+static bool runRound(DHTBus& bus, unsigned long limitMs = 5000)
+{
+  for (unsigned long i = 0; i < limitMs * 10; i++) {
+    if (bus.poll()) {
+      return true;
+    }
+    hostAdvance(100);
+  }
+  return false;
+}
+
+TEST(full_bus)
+{
+  DHT sensors[] = {
+    DHT(2, DHT11), DHT(3, DHT11), DHT(21, DHT11), DHT(20, DHT11), DHT(19, DHT11),
+  };
+  DHTBus bus;
+
+  for (uint8_t i = 0; i < DHT_BUS_MAX; i++) {
+    CHECK_EQ(i, bus.add(sensors[i]));
+  }
+  CHECK_EQ(DHT_BUS_INVALID, bus.add(sensors[DHT_BUS_MAX]));
+  CHECK_EQ(DHT_BUS_MAX, bus.count());
+
+  // what add() gave back for the sensor that didn't fit reports no data
+  uint8_t invalid = DHT_BUS_INVALID;
+  CHECK(!bus.sample(invalid).valid);
+  CHECK(isnan(bus.sample(invalid).temperature));
+  CHECK(isnan(bus.sample(invalid).humidity));
+  CHECK_EQ(0, bus.sample(invalid).failures);
+  CHECK_EQ(0, bus.reads(invalid));
+  CHECK_EQ(0, bus.failures(invalid));
+  CHECK(!bus.sample(DHT_BUS_MAX).valid);
+}
+
+TEST(staggered_round)
+{
+  static const uint8_t pins[DHT_BUS_MAX] = { 2, 3, 21, 41 };
+  DHTSensor* simulated[DHT_BUS_MAX];
+  DHT* sensors[DHT_BUS_MAX];
+  DHTBus bus;
+
+  for (uint8_t i = 0; i < DHT_BUS_MAX; i++) {
+    simulated[i] = new DHTSensor(pins[i]);
+    simulated[i]->setDHT11(40 + i, 0, 20 + i, 5);
+    sensors[i] = new DHT(pins[i], DHT11);
+    sensors[i]->begin();
+    CHECK_EQ(i, bus.add(*sensors[i]));
+  }
+
+  CHECK(runRound(bus));
+  for (uint8_t i = 0; i < DHT_BUS_MAX; i++) {
+    CHECK(bus.sample(i).valid);
+    CHECK_NEAR(40 + i, bus.sample(i).humidity, 1e-4);
+    CHECK_NEAR(20.5 + i, bus.sample(i).temperature, 1e-4);
+    CHECK_EQ(1, bus.reads(i));
+    CHECK_EQ(0, bus.failures(i));
+    CHECK_EQ(1, simulated[i]->frames);
+  }
+
+  // about 25 + 6 * (N - 1) ms rather than 25 * N
+  printf("round of %d DHT11s: %u ms\n", DHT_BUS_MAX, (unsigned)bus.roundTime());
+  CHECK(bus.roundTime() >= 20 + DHT_BUS_STAGGER * (DHT_BUS_MAX - 1));
+  CHECK(bus.roundTime() <= 25 + DHT_BUS_STAGGER * (DHT_BUS_MAX - 1) + 5);
+
+  // the next round starts an interval after the last one did
+  host_time_t end = hostNow();
+  CHECK(runRound(bus));
+  CHECK((hostNow() - end) / 1000 >= 2000 - bus.roundTime() - 1);
+  CHECK_EQ(2, bus.reads(0));
+
+  // a failing sensor is counted on its own channel only
+  simulated[1]->corruptChecksum = true;
+  simulated[2]->reply = false;
+  CHECK(runRound(bus));
+  CHECK_EQ(3, bus.reads(1));
+  CHECK_EQ(1, bus.failures(1));
+  CHECK_EQ(1, bus.failures(2));
+  CHECK_EQ(0, bus.failures(0));
+  CHECK_EQ(0, bus.failures(3));
+  CHECK(!bus.sample(1).valid);
+  CHECK(bus.sample(3).valid);
+
+  for (uint8_t i = 0; i < DHT_BUS_MAX; i++) {
+    delete sensors[i];
+    delete simulated[i];
+  }
+}
+
+// a polled capture keeps interrupts off for the whole frame, so it waits
+// for an edge-timed capture that is under way instead of cutting it short
+TEST(polled_capture_waits_for_an_edge_capture)
+{
+  DHTSensor edgeSensor(21);
+  DHTSensor polledSensor(41);
+  DHT edge(21, DHT11);
+  DHT polled(41, DHT11);
+
+  edgeSensor.setDHT11(40, 0, 20, 0);
+  polledSensor.setDHT11(60, 0, 25, 0);
+  edge.begin();
+  polled.begin();
+
+  // the polled start signal ends while the other reply is coming in
+  CHECK(edge.startRead(true));
+  hostAdvance(1000);
+  CHECK(polled.startRead(true));
+
+  bool edgeDone = false;
+  bool polledDone = false;
+  for (int i = 0; i < 1000 && !(edgeDone && polledDone); i++) {
+    edgeDone = edgeDone || edge.poll();
+    polledDone = polledDone || polled.poll();
+    hostAdvance(100);
+  }
+  CHECK(edgeDone && polledDone);
+  CHECK(edge.sample().valid);
+  CHECK(polled.sample().valid);
+  CHECK_NEAR(40.0, edge.sample().humidity, 1e-4);
+  CHECK_NEAR(60.0, polled.sample().humidity, 1e-4);
+}
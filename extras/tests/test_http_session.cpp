@@ -0,0 +1,191 @@
+#include <HTTPSession.h>
+#include <JSONDecoder.h>
+
+#include "ArduinoHost.h"
+#include "test.h"
+
+// as in ESP8266HTTPClient.h
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+
+// what a connection costs on the simulated link
+#define HANDSHAKE_MS 180   // DNS and the TCP handshake
+#define REQUEST_MS 60      // request out, reply back
+#define RESET_MS 30        // a request into a closed connection, until the reset
+
+struct WeatherNow {
+  double temp;
+  int humidity;
+};
+
+static const JSONField weatherSchema[] = {
+  JSON_FIELD(WeatherNow, temp, "main.temp"),
+  JSON_FIELD(WeatherNow, humidity, "main.humidity"),
+};
+
+static const char reply[] =
+  "{\"weather\":[{\"id\":800,\"main\":\"Clear\"}],"
+  "\"main\":{\"temp\":288.71,\"humidity\":58},\"name\":\"London\"}";
+
+class FakeClient {
+};
+
+// HTTPClient against a stand-in weather server.  Like WiFiClient, a
+// connection the server closed still reads as connected until a request
+// goes out on it.
+class FakeHTTP {
+public:
+  FakeHTTP() : reuse(false), open(false), closedByServer(false), serverDown(false),
+               begins(0), accepted(0), requests(0)
+  {
+  }
+
+  bool begin(FakeClient& client, const String& u)
+  {
+    (void)client;
+    begins++;
+    url = u;
+    return true;
+  }
+
+  void setReuse(bool r) { reuse = r; }
+  bool connected() { return open; }
+
+  int GET()
+  {
+    requests++;
+    if (open && closedByServer) {
+      delay(RESET_MS);
+      open = false;
+      return HTTPC_ERROR_CONNECTION_LOST;
+    }
+    if (!open) {
+      delay(HANDSHAKE_MS);
+      if (serverDown) {
+        return HTTPC_ERROR_CONNECTION_FAILED;
+      }
+      accepted++;
+      open = true;
+      closedByServer = false;
+    }
+    delay(REQUEST_MS);
+    return 200;
+  }
+
+  template <typename S>
+  int writeToStream(S* output)
+  {
+    int written = output->print(reply);
+    if (!reuse) {
+      open = false;
+    }
+    return written;
+  }
+
+  // the server drops the idle connection
+  void serverClose() { closedByServer = open; }
+
+  bool reuse;
+  bool open;
+  bool closedByServer;
+  bool serverDown;
+  String url;
+  unsigned int begins;
+  unsigned int accepted;   // connections the server took
+  unsigned int requests;   // GET() calls, failed ones included
+};
+
+static int poll(HTTPSession<FakeHTTP, FakeClient>& session, WeatherNow& weather)
+{
+  JSONDecoder<WeatherNow> decoder(weatherSchema, 2);
+
+  decoder.begin(weather);
+  int code = session.GET(&decoder);
+  return decoder.end() == JSON_DECODE_OK ? code : -100;
+}
+
+TEST(connection_is_reused)
+{
+  FakeClient client;
+  FakeHTTP http;
+  HTTPSession<FakeHTTP, FakeClient> session(http, client);
+  WeatherNow weather;
+
+  CHECK(!session.ready());
+  CHECK(session.begin("http://api.openweathermap.org/data/2.5/weather?q=Atlanta,US"));
+  CHECK(session.ready());
+  CHECK(http.reuse);
+
+  for (int i = 0; i < 5; i++) {
+    weather.humidity = 0;
+    CHECK_EQ(200, poll(session, weather));
+    CHECK_EQ(58, weather.humidity);
+    printf("poll %d: %lu ms, %lu TCP connections\n", i, session.latency(), session.connections());
+    if (i == 0) {
+      CHECK(session.latency() >= HANDSHAKE_MS + REQUEST_MS);
+    } else {
+      CHECK(session.latency() < HANDSHAKE_MS);
+    }
+  }
+  CHECK_EQ(1, session.connections());
+  CHECK_EQ(1, http.accepted);
+  CHECK_EQ(5, http.requests);
+  CHECK_EQ(1, http.begins);
+}
+
+// the idle connection was closed by the server: one failed request, then
+// the same poll goes out on a new connection
+TEST(server_close_reconnects)
+{
+  FakeClient client;
+  FakeHTTP http;
+  HTTPSession<FakeHTTP, FakeClient> session(http, client);
+  WeatherNow weather;
+
+  session.begin("http://api.openweathermap.org/data/2.5/weather?q=Atlanta,US");
+  CHECK_EQ(200, poll(session, weather));
+
+  http.serverClose();
+  weather.humidity = 0;
+  CHECK_EQ(200, poll(session, weather));
+  CHECK_EQ(58, weather.humidity);
+  CHECK_EQ(RESET_MS + HANDSHAKE_MS + REQUEST_MS, session.latency());
+  CHECK_EQ(2, session.connections());
+  CHECK_EQ(2, http.accepted);
+
+  // and stays on the new one
+  CHECK_EQ(200, poll(session, weather));
+  CHECK_EQ(2, session.connections());
+  CHECK_EQ(4, http.requests);
+}
+
+// a retry only follows a failed reused connection, and only one
+TEST(retry_once)
+{
+  FakeClient client;
+  FakeHTTP http;
+  HTTPSession<FakeHTTP, FakeClient> session(http, client);
+  WeatherNow weather;
+
+  session.begin("http://api.openweathermap.org/data/2.5/weather?q=Atlanta,US");
+  http.serverDown = true;
+  CHECK_EQ(HTTPC_ERROR_CONNECTION_FAILED, session.GET(&Serial));
+  CHECK_EQ(1, http.requests);
+  CHECK_EQ(1, session.connections());
+
+  http.serverDown = false;
+  CHECK_EQ(200, poll(session, weather));
+
+  // closed and then down: the retry fails too, and the next poll tries again
+  http.serverClose();
+  http.serverDown = true;
+  CHECK_EQ(HTTPC_ERROR_CONNECTION_FAILED, session.GET(&Serial));
+  CHECK_EQ(4, http.requests);
+  CHECK_EQ(3, session.connections());
+  CHECK(!http.open);
+
+  http.serverDown = false;
+  CHECK_EQ(200, poll(session, weather));
+  CHECK_EQ(4, session.connections());
+  CHECK_EQ(2, http.accepted);
+}
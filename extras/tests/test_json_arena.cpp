@@ -0,0 +1,211 @@
+#include <stdint.h>
+
+#include <chrono>
+
+#include <Arduino_JSON.h>
+
+#include "cjson/cJSON.h"
+
+#include "test.h"
+
+static unsigned int heapAllocations;
+static unsigned int heapFrees;
+
+static void* countingMalloc(size_t size)
+{
+  heapAllocations++;
+  return malloc(size);
+}
+
+static void countingFree(void* ptr)
+{
+  if (ptr) {
+    heapFrees++;
+  }
+  free(ptr);
+}
+
+static struct cJSON_Hooks countingHooks = { countingMalloc, countingFree };
+
+static const char weather[] =
+  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":800,\"main\":\"Clear\"}],"
+  "\"main\":{\"temp\":288.71,\"humidity\":58},\"name\":\"London\"}";
+
+TEST(allocations_come_from_the_buffer)
+{
+  static uint8_t buffer[2048];
+
+  JSONArena::setHooks(&countingHooks);
+  heapAllocations = 0;
+  {
+    JSONArena arena(buffer, sizeof(buffer));
+    {
+      JSONVar doc = JSON.parse(weather);
+      CHECK((double)doc["main"]["temp"] == 288.71);
+      CHECK(arena.allocations() > 0);
+      CHECK(arena.used() > 0);
+      CHECK_EQ(arena.used(), arena.highWater());
+
+      // only the newest block can be handed back
+      size_t used = arena.used();
+      size_t block = (100 + JSON_ARENA_ALIGN - 1) / JSON_ARENA_ALIGN * JSON_ARENA_ALIGN;
+      void* first = cJSON_malloc(100);
+      void* second = cJSON_malloc(100);
+      cJSON_free(first);
+      CHECK_EQ(used + 2 * block, arena.used());
+      cJSON_free(second);
+      CHECK_EQ(used + block, arena.used());
+      CHECK_EQ(used + 2 * block, arena.highWater());
+
+      String text = JSON.stringify(doc["main"]);
+      CHECK_STR("{\"temp\":288.71,\"humidity\":58}", text.c_str());
+    }
+    CHECK_EQ(0, arena.overflows());
+    CHECK(arena.highWater() <= arena.size());
+  }
+  CHECK_EQ(0, heapAllocations);
+
+  // the hooks the arena replaced are back
+  {
+    JSONVar doc = JSON.parse(weather);
+    CHECK(JSON.typeof(doc) == "object");
+  }
+  CHECK(heapAllocations > 0);
+  CHECK_EQ(heapAllocations, heapFrees);
+  JSONArena::setHooks(NULL);
+}
+
+TEST(overflow_goes_to_the_hooks)
+{
+  static uint8_t buffer[64];
+
+  JSONArena::setHooks(&countingHooks);
+  heapAllocations = 0;
+  heapFrees = 0;
+  {
+    JSONArena arena(buffer, sizeof(buffer));
+    {
+      JSONVar doc = JSON.parse(weather);
+      CHECK_STR("London", (const char*)doc["name"]);
+    }
+    CHECK(arena.overflows() > 0);
+    CHECK_EQ(arena.overflows(), heapAllocations);
+    CHECK_EQ(heapAllocations, heapFrees);
+    CHECK(arena.highWater() <= arena.size());
+  }
+  JSONArena::setHooks(NULL);
+}
+
+TEST(nested_arenas)
+{
+  static uint8_t outerBuffer[2048];
+  static uint8_t innerBuffer[2048];
+
+  JSONArena::setHooks(&countingHooks);
+  heapAllocations = 0;
+  {
+    JSONArena outer(outerBuffer, sizeof(outerBuffer));
+    JSONVar kept = JSON.parse("[1,2,3]");
+    unsigned int outerAllocations = outer.allocations();
+
+    {
+      JSONArena inner(innerBuffer, sizeof(innerBuffer));
+      JSONVar doc = JSON.parse(weather);
+      CHECK(inner.allocations() > 0);
+      CHECK_EQ(outerAllocations, outer.allocations());
+    }
+
+    // the outer arena's hooks are back once the inner one goes
+    JSONVar more = JSON.parse("[4]");
+    CHECK(outer.allocations() > outerAllocations);
+    CHECK_EQ(3, kept.length());
+    CHECK((int)more[0] == 4);
+  }
+  CHECK_EQ(0, heapAllocations);
+
+  // setHooks() inside an arena takes effect when the last arena goes
+  {
+    JSONArena arena(outerBuffer, sizeof(outerBuffer));
+    JSONArena::setHooks(NULL);
+    JSONVar doc = JSON.parse("{}");
+    CHECK(arena.allocations() > 0);
+  }
+  heapAllocations = 0;
+  {
+    JSONVar doc = JSON.parse("{}");
+  }
+  CHECK_EQ(0, heapAllocations);
+}
+
+TEST(alignment)
+{
+  static uint8_t buffer[1024 + JSON_ARENA_ALIGN];
+
+  // start one byte past an aligned address
+  uint8_t* start = buffer;
+  while ((uintptr_t)start % JSON_ARENA_ALIGN != 1) {
+    start++;
+  }
+
+  JSONArena arena(start, 1024);
+  CHECK_EQ(1024 - (JSON_ARENA_ALIGN - 1), arena.size());
+
+  cJSON* items[8];
+  for (int i = 0; i < 8; i++) {
+    items[i] = cJSON_CreateNumber(i);
+    CHECK_EQ(0, (uintptr_t)items[i] % JSON_ARENA_ALIGN);
+    CHECK((uint8_t*)items[i] >= start && (uint8_t*)items[i] < start + 1024);
+  }
+  CHECK_EQ(8, arena.allocations());
+  for (int i = 0; i < 8; i++) {
+    cJSON_Delete(items[i]);
+  }
+}
+
+// Not a check: heap allocations and parse time of the weather sample with
+// and without an arena, on this machine.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  static uint8_t buffer[2048];
+  const int n = 20000;
+  unsigned int arenaAllocations;
+  size_t highWater;
+
+  JSONArena::setHooks(&countingHooks);
+  heapAllocations = 0;
+  {
+    JSONVar doc = JSON.parse(weather);
+  }
+  unsigned int mallocAllocations = heapAllocations;
+
+  heapAllocations = 0;
+  {
+    JSONArena arena(buffer, sizeof(buffer));
+    {
+      JSONVar doc = JSON.parse(weather);
+    }
+    arenaAllocations = arena.allocations();
+    highWater = arena.highWater();
+  }
+  CHECK_EQ(0, heapAllocations);
+  CHECK_EQ(mallocAllocations, arenaAllocations);
+  JSONArena::setHooks(NULL);
+  printf("%u heap allocations per parse with malloc, 0 with an arena (%u blocks, %u bytes)\n",
+         mallocAllocations, arenaAllocations, (unsigned)highWater);
+
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    JSONVar doc = JSON.parse(weather);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    JSONArena arena(buffer, sizeof(buffer));
+    JSONVar doc = JSON.parse(weather);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  printf("parse: %.2f us with malloc, %.2f us with an arena\n",
+         std::chrono::duration<double, std::micro>(t1 - t0).count() / n,
+         std::chrono::duration<double, std::micro>(t2 - t1).count() / n);
+}
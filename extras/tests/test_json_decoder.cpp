@@ -0,0 +1,182 @@
+#include <limits.h>
+#include <string>
+
+#include <JSONDecoder.h>
+
+#include "test.h"
+
+struct Weather {
+  double temp;
+  float feelsLike;
+  int humidity;
+  long pressure;
+  unsigned long sunrise;
+  bool snow;
+  char name[8];
+};
+
+static const JSONField weatherSchema[] = {
+  JSON_FIELD(Weather, temp, "main.temp"),
+  JSON_FIELD(Weather, feelsLike, "main.feels_like"),
+  JSON_FIELD(Weather, humidity, "main.humidity"),
+  JSON_OPTIONAL_FIELD(Weather, pressure, "main.pressure"),
+  JSON_FIELD(Weather, sunrise, "sys.sunrise"),
+  JSON_OPTIONAL_FIELD(Weather, snow, "snow"),
+  JSON_FIELD(Weather, name, "name"),
+};
+
+static const char reply[] =
+  "{\"weather\":[{\"id\":800,\"main\":\"Clear\"}],"
+  "\"main\":{\"temp\":288.71,\"feels_like\":287.82,\"pressure\":1019,\"humidity\":58},"
+  "\"sys\":{\"sunrise\":1747627268},\"snow\":false,\"name\":\"London\"}";
+
+// the result of decoding reply with from replaced by to
+static uint8_t decodeEdited(const char* from, const char* to, Weather& weather)
+{
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  std::string text(reply);
+  size_t at = text.find(from);
+
+  if (at == std::string::npos) {
+    printf("not in the reply: %s\n", from);
+    return 0xFF;
+  }
+  text.replace(at, strlen(from), to);
+  return decoder.decode(weather, text.c_str());
+}
+
+TEST(decodes_every_member)
+{
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  Weather weather;
+
+  memset(&weather, 0, sizeof(weather));
+  CHECK_EQ(JSON_DECODE_OK, decoder.decode(weather, reply));
+  CHECK_EQ(-1, decoder.errorField());
+  CHECK(decoder.errorPath() == NULL);
+  CHECK(weather.temp == 288.71);
+  CHECK(weather.feelsLike == 287.82f);
+  CHECK_EQ(58, weather.humidity);
+  CHECK_EQ(1019, weather.pressure);
+  CHECK_EQ(1747627268UL, weather.sunrise);
+  CHECK(!weather.snow);
+  CHECK_STR("London", weather.name);
+}
+
+TEST(chunked_and_stopped_early)
+{
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  Weather weather;
+
+  decoder.begin(weather);
+  for (const char* p = reply; *p; p++) {
+    decoder.write((uint8_t)*p);
+  }
+  CHECK_EQ(JSON_DECODE_OK, decoder.end());
+  CHECK_STR("London", weather.name);
+
+  // the last field is the end of what is read; the rest may be anything
+  std::string cut(reply, strstr(reply, "\"London\"") + 8);
+  cut += ", garbage";
+  CHECK_EQ(JSON_DECODE_OK, decoder.decode(weather, cut.c_str()));
+}
+
+TEST(strings_are_cut_to_fit)
+{
+  Weather weather;
+
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("\"London\"", "\"Llanfairpwllgwyngyll\"", weather));
+  CHECK_STR("Llanfai", weather.name);
+}
+
+TEST(missing)
+{
+  Weather weather;
+
+  CHECK_EQ(JSON_DECODE_MISSING, decodeEdited("\"humidity\"", "\"humidity2\"", weather));
+
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  decoder.decode(weather, "{\"main\":{\"temp\":1,\"feels_like\":2,\"humidity\":3},\"name\":\"x\"}");
+  CHECK_EQ(JSON_DECODE_MISSING, decoder.error());
+  CHECK_EQ(4, decoder.errorField());
+  CHECK_STR("sys.sunrise", decoder.errorPath());
+
+  // optional members that are missing keep their value
+  weather.pressure = 42;
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("\"pressure\":1019,", "", weather));
+  CHECK_EQ(42, weather.pressure);
+  weather.snow = true;
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("\"snow\":false,", "", weather));
+  CHECK(weather.snow);
+}
+
+TEST(wrong_type)
+{
+  Weather weather;
+
+  CHECK_EQ(JSON_DECODE_TYPE, decodeEdited("288.71", "\"288.71\"", weather));
+  CHECK_EQ(JSON_DECODE_TYPE, decodeEdited("\"London\"", "7", weather));
+  CHECK_EQ(JSON_DECODE_TYPE, decodeEdited("\"snow\":false", "\"snow\":null", weather));
+  CHECK_EQ(JSON_DECODE_TYPE, decodeEdited("\"snow\":false", "\"snow\":0", weather));
+  CHECK_EQ(JSON_DECODE_TYPE, decodeEdited("58", "true", weather));
+}
+
+TEST(range)
+{
+  Weather weather;
+  char text[48];
+
+  // int and long take [min, max], unsigned long [0, max]; fractions truncate
+  snprintf(text, sizeof(text), "%d", INT_MAX);
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("58", text, weather));
+  CHECK_EQ(INT_MAX, weather.humidity);
+  snprintf(text, sizeof(text), "%d", INT_MIN);
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("58", text, weather));
+  CHECK_EQ(INT_MIN, weather.humidity);
+  snprintf(text, sizeof(text), "%.0f", (double)INT_MAX + 1);
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("58", text, weather));
+  snprintf(text, sizeof(text), "%.0f", (double)INT_MIN - 1);
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("58", text, weather));
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("58", "-7.9", weather));
+  CHECK_EQ(-7, weather.humidity);
+
+  snprintf(text, sizeof(text), "%.0f", -2.0 * LONG_MIN);
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("1019", text, weather));
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("1747627268", text, weather));
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("1747627268", "-1", weather));
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("1747627268", "-0.5", weather));
+  CHECK_EQ(0, weather.sunrise);
+
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("287.82", "1e39", weather));
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("288.71", "1e999", weather));
+  CHECK_EQ(JSON_DECODE_RANGE, decodeEdited("288.71", "-1e999", weather));
+  CHECK_EQ(JSON_DECODE_OK, decodeEdited("288.71", "1e300", weather));
+
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  std::string text2(reply);
+  text2.replace(text2.find("58"), 2, "1e20");
+  decoder.decode(weather, text2.c_str());
+  CHECK_EQ(2, decoder.errorField());
+  CHECK_STR("main.humidity", decoder.errorPath());
+}
+
+TEST(incomplete_and_syntax)
+{
+  JSONDecoder<Weather> decoder(weatherSchema, 7);
+  Weather weather;
+
+  std::string cut(reply, strstr(reply, "\"sys\""));
+  CHECK_EQ(JSON_DECODE_INCOMPLETE, decoder.decode(weather, cut.c_str()));
+  CHECK_EQ(JSON_DECODE_INCOMPLETE, decoder.decode(weather, ""));
+
+  CHECK_EQ(JSON_DECODE_SYNTAX, decoder.decode(weather, "{\"main\":{\"temp\":288.71,}}"));
+  CHECK_EQ(-1, decoder.errorField());
+  CHECK(decoder.errorPath() == NULL);
+  CHECK_EQ(JSON_DECODE_SYNTAX, decoder.decode(weather, "{\"main\":{\"temp\":01}}"));
+
+  // a complete document without the fields is missing them, not incomplete
+  CHECK_EQ(JSON_DECODE_MISSING, decoder.decode(weather, "{}"));
+
+  // decoding again starts over
+  CHECK_EQ(JSON_DECODE_OK, decoder.decode(weather, reply));
+}
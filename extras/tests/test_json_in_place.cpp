@@ -0,0 +1,253 @@
+#include <chrono>
+
+#include <Arduino_JSON.h>
+
+#include "cjson/cJSON.h"
+
+#include "test.h"
+
+static unsigned int allocations;
+static size_t allocated;
+
+static void* countingMalloc(size_t size)
+{
+  allocations++;
+  allocated += size;
+  return malloc(size);
+}
+
+// parseInPlace() of a copy of text, which has to fail
+static bool rejected(const char* text)
+{
+  char buffer[128];
+
+  snprintf(buffer, sizeof(buffer), "%s", text);
+  JSONVar doc = JSON.parseInPlace(buffer);
+  bool undefined = JSON.typeof(doc) == "undefined";
+  if (!undefined) {
+    printf("accepted: %s\n", text);
+  }
+  return undefined;
+}
+
+TEST(values)
+{
+  char text[] = "{\"name\":\"fan\",\"temp\":23.5,\"list\":[1,-2,3e2,-0.25],"
+                "\"ok\":true,\"off\":false,\"none\":null,\"empty\":{},\"nothing\":[]}";
+  JSONVar doc = JSON.parseInPlace(text);
+
+  CHECK(JSON.typeof(doc) == "object");
+  CHECK_STR("fan", (const char*)doc["name"]);
+  CHECK((double)doc["temp"] == 23.5);
+  CHECK_EQ(4, doc["list"].length());
+  CHECK((double)doc["list"][2] == 300);
+  CHECK((double)doc["list"][3] == -0.25);
+  CHECK((bool)doc["ok"]);
+  CHECK(!(bool)doc["off"]);
+  CHECK(doc["none"] == nullptr);
+  CHECK(JSON.typeof(doc["empty"]) == "object");
+  CHECK_EQ(0, doc["nothing"].length());
+}
+
+TEST(strings_stay_in_the_buffer)
+{
+  char text[] = "  {\"city\" : \"Lon\\\"don\", \"w\":[{\"d\":\"clear\\nsky\"}]}\n";
+  JSONVar doc = JSON.parseInPlace(text);
+
+  const char* city = doc.get("city").asString();
+  const char* description = doc.get("w").get(0).get("d").asString();
+
+  CHECK_STR("Lon\"don", city);
+  CHECK_STR("clear\nsky", description);
+  CHECK(city > text && city < text + sizeof(text));
+  CHECK(description > text && description < text + sizeof(text));
+}
+
+TEST(only_nodes_are_allocated)
+{
+  struct cJSON_Hooks hooks = { countingMalloc, free };
+  char text[] = "{\"a\":\"one\",\"b\":[\"two\",\"three\"],\"c\":{\"d\":\"four\"}}";
+
+  JSONArena::setHooks(&hooks);
+  allocations = 0;
+  {
+    JSONVar doc = JSON.parseInPlace(text);
+    CHECK(JSON.typeof(doc) == "object");
+  }
+  JSONArena::setHooks(NULL);
+
+  // root, a, b, two, three, c, d
+  CHECK_EQ(7, allocations);
+}
+
+TEST(same_tree_as_cJSON_Parse)
+{
+  static const char* samples[] = {
+    "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":800,\"main\":\"Clear\"}],"
+    "\"main\":{\"temp\":288.71,\"feels_like\":287.82,\"pressure\":1019,\"humidity\":58}}",
+    "[\"\\u00e9\\u20ac\\ud83d\\ude00\", \"\\/\\b\\f\\r\\t\", 1e-7, -0, 12345678901234567890]",
+    "\"just a string\"",
+    "  42  ",
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    char buffer[256];
+    strcpy(buffer, samples[i]);
+
+    JSONVar inPlace = JSON.parseInPlace(buffer);
+    JSONVar copied = JSON.parse(samples[i]);
+
+    CHECK(JSON.typeof(inPlace) != "undefined");
+    CHECK_STR(JSON.stringify(copied).c_str(), JSON.stringify(inPlace).c_str());
+  }
+}
+
+TEST(numbers_follow_the_json_grammar)
+{
+  CHECK(rejected("-"));
+  CHECK(rejected("-x"));
+  CHECK(rejected("[-]"));
+  CHECK(rejected("-.5"));
+  CHECK(rejected(".5"));
+  CHECK(rejected("+1"));
+  CHECK(rejected("01"));
+  CHECK(rejected("[1.]"));
+  CHECK(rejected("1e"));
+  CHECK(rejected("{\"a\":1.2.3}"));
+  CHECK(rejected("0x10"));
+}
+
+TEST(trailing_content)
+{
+  CHECK(rejected("{} x"));
+  CHECK(rejected("[1] [2]"));
+  CHECK(rejected("1 2"));
+  CHECK(rejected("true,"));
+
+  char text[] = "{\"a\":1} \r\n\t";
+  CHECK(JSON.typeof(JSON.parseInPlace(text)) == "object");
+}
+
+TEST(surrogates_and_nul)
+{
+  CHECK(rejected("\"\\u0000\""));
+  CHECK(rejected("\"a\\u0000b\""));
+  CHECK(rejected("\"\\uDC00\""));
+  CHECK(rejected("\"\\uD83D\""));
+  CHECK(rejected("\"\\uD83Dx\""));
+  CHECK(rejected("\"\\uD83D\\u0041\""));
+  CHECK(rejected("\"\\uD83D\\uD83D\""));
+
+  char text[] = "\"\\uD83D\\uDE00\"";
+  JSONVar smile = JSON.parseInPlace(text);
+  CHECK_STR("\xF0\x9F\x98\x80", (const char*)smile);
+}
+
+TEST(malformed)
+{
+  static const char* samples[] = {
+    "", " ", "[", "]", "{", "[1,]", "[,1]", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "{\"a\"}",
+    "tru", "nul", "falsey", "\"abc", "\"\\x\"", "\"\\u12\"", "[1 2]", "{\"a\":1 \"b\":2}",
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    CHECK(rejected(samples[i]));
+  }
+}
+
+TEST(depth_limit)
+{
+  char text[80];
+
+  memset(text, '[', 32);
+  memset(text + 32, ']', 32);
+  text[64] = '\0';
+  CHECK(JSON.typeof(JSON.parseInPlace(text)) == "array");
+
+  memset(text, '[', 33);
+  memset(text + 33, ']', 33);
+  text[66] = '\0';
+  CHECK(rejected(text));
+}
+
+// copies must not point into the buffer: it is overwritten and the
+// document gone before they are read
+TEST(copies_own_their_keys)
+{
+  JSONVar copy;
+  JSONVar member;
+  JSONVar* constructed;
+
+  {
+    char text[] = "{\"main\":{\"temp\":281.5,\"humidity\":76},\"name\":\"London\"}";
+    JSONVar doc = JSON.parseInPlace(text);
+    JSONVar main = doc["main"];
+
+    copy = doc;
+    member = main;
+    constructed = new JSONVar(doc);
+    memset(text, 'x', sizeof(text) - 1);
+  }
+
+  CHECK_STR("{\"main\":{\"temp\":281.5,\"humidity\":76},\"name\":\"London\"}",
+            JSON.stringify(copy).c_str());
+  CHECK_STR("{\"temp\":281.5,\"humidity\":76}", JSON.stringify(member).c_str());
+  CHECK_STR("London", (const char*)(*constructed)["name"]);
+  CHECK((double)member["humidity"] == 76);
+  delete constructed;
+}
+
+static const char weather[] =
+  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},\"weather\":[{\"id\":800,\"main\":\"Clear\","
+  "\"description\":\"clear sky\",\"icon\":\"01d\"}],\"base\":\"stations\",\"main\":{\"temp\":281.52,"
+  "\"feels_like\":278.99,\"temp_min\":280.15,\"temp_max\":283.71,\"pressure\":1016,"
+  "\"humidity\":76},\"visibility\":10000,\"wind\":{\"speed\":4.12,\"deg\":250},"
+  "\"clouds\":{\"all\":0},\"dt\":1605182400,\"sys\":{\"type\":1,\"id\":1414,"
+  "\"country\":\"GB\",\"sunrise\":1605165117,\"sunset\":1605197621},\"timezone\":0,"
+  "\"id\":2643743,\"name\":\"London\",\"cod\":200}";
+
+// Not a check: heap use and parse time of a weather reply against
+// cJSON_Parse on this machine.  The in-place time includes copying the
+// reply into a fresh buffer.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  struct cJSON_Hooks hooks = { countingMalloc, free };
+  char buffer[sizeof(weather)];
+  const int n = 20000;
+
+  JSONArena::setHooks(&hooks);
+  allocations = 0;
+  allocated = 0;
+  memcpy(buffer, weather, sizeof(weather));
+  {
+    JSONVar doc = JSON.parseInPlace(buffer);
+    CHECK((double)doc["main"]["humidity"] == 76);
+  }
+  unsigned int inPlaceAllocations = allocations;
+  size_t inPlaceBytes = allocated;
+
+  allocations = 0;
+  allocated = 0;
+  cJSON_Delete(cJSON_Parse(weather));
+  printf("%u bytes in %u blocks in place, %u bytes in %u blocks with cJSON_Parse\n",
+         (unsigned)inPlaceBytes, inPlaceAllocations, (unsigned)allocated, allocations);
+  CHECK(inPlaceAllocations < allocations);
+  CHECK(inPlaceBytes < allocated);
+  JSONArena::setHooks(NULL);
+
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    memcpy(buffer, weather, sizeof(weather));
+    JSONVar doc = JSON.parseInPlace(buffer);
+  }
+  Clock::time_point t1 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    cJSON_Delete(cJSON_Parse(weather));
+  }
+  Clock::time_point t2 = Clock::now();
+
+  printf("in place %.2f us, cJSON_Parse %.2f us per reply\n",
+         std::chrono::duration<double, std::micro>(t1 - t0).count() / n,
+         std::chrono::duration<double, std::micro>(t2 - t1).count() / n);
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <string>
+
+#include <Arduino_JSON.h>
+#include <JSONIndex.h>
+
+#include "cjson/cJSON.h"
+
+#include "test.h"
+
+// {"k0":0,"k1":1,...} with count members
+static cJSON* makeObject(int count)
+{
+  cJSON* object = cJSON_CreateObject();
+
+  for (int i = 0; i < count; i++) {
+    char key[16];
+
+    snprintf(key, sizeof(key), "k%d", i);
+    cJSON_AddItemToObject(object, key, cJSON_CreateNumber(i));
+  }
+
+  return object;
+}
+
+// the index gives what cJSON's own lookups give, twice over so the second
+// pass goes through the table
+static void checkAgainstCJSON(cJSON* object, const char* const* keys, size_t count)
+{
+  for (int pass = 0; pass < 2; pass++) {
+    for (size_t i = 0; i < count; i++) {
+      CHECK(JSONIndex::find(object, keys[i]) == cJSON_GetObjectItemCaseSensitive(object, keys[i]));
+      CHECK(JSONIndex::find(object, keys[i], false) == cJSON_GetObjectItem(object, keys[i]));
+    }
+  }
+}
+
+TEST(duplicates_and_case_match_cJSON)
+{
+  const char* text =
+    "{\"temp\":1,\"Temp\":2,\"TEMP\":3,\"temp\":4,\"humidity\":5,\"name\":\"a\",\"Name\":\"b\","
+    "\"speed\":6,\"deg\":7,\"gust\":8,\"speed\":9,\"x\":10,\"\":11,\"a_b\":12,\"A_B\":13}";
+  static const char* keys[] = {
+    "temp", "Temp", "TEMP", "tEmP", "humidity", "HUMIDITY", "name", "Name", "NAME", "speed", "SPEED",
+    "deg", "gust", "x", "X", "", "a_b", "A_B", "a_B", "missing", "tem", "temps", "[", "@", "_",
+  };
+
+  // small objects are scanned, large ones indexed; both agree with cJSON
+  cJSON* small = cJSON_Parse("{\"a\":1,\"A\":2,\"a\":3}");
+  static const char* smallKeys[] = { "a", "A", "b" };
+  checkAgainstCJSON(small, smallKeys, 3);
+
+  cJSON* large = cJSON_Parse(text);
+  CHECK(cJSON_GetArraySize(large) >= JSON_INDEX_MIN_KEYS);
+  checkAgainstCJSON(large, keys, sizeof(keys) / sizeof(*keys));
+
+  // the first of several duplicates wins, as in cJSON
+  CHECK_EQ(1, JSONIndex::find(large, "temp")->valueint);
+  CHECK_EQ(1, JSONIndex::find(large, "TEMP", false)->valueint);
+  CHECK_EQ(3, JSONIndex::find(large, "TEMP")->valueint);
+  CHECK_EQ(6, JSONIndex::find(large, "speed")->valueint);
+
+  JSONIndex::invalidate();
+  cJSON_Delete(small);
+  cJSON_Delete(large);
+}
+
+TEST(many_keys)
+{
+  cJSON* object = makeObject(1000);
+
+  for (int pass = 0; pass < 3; pass++) {
+    for (int i = 0; i < 1000; i++) {
+      char key[16];
+
+      snprintf(key, sizeof(key), "K%d", i);
+      CHECK(JSONIndex::find(object, key) == NULL);
+      cJSON* found = JSONIndex::find(object, key, false);
+      CHECK(found != NULL && found->valueint == i);
+    }
+  }
+  CHECK(JSONIndex::find(object, "k1000") == NULL);
+  CHECK(JSONIndex::find(NULL, "k1") == NULL);
+  CHECK(JSONIndex::find(object, NULL) == NULL);
+
+  JSONIndex::invalidate();
+  cJSON_Delete(object);
+}
+
+TEST(tables_are_rebuilt_after_edits)
+{
+  JSONVar doc = JSON.parse(
+    "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"f\":6,\"g\":7,\"h\":8,\"i\":9,\"j\":10}");
+
+  CHECK(doc.hasOwnProperty("j"));
+  CHECK(doc.hasOwnProperty("j"));
+  CHECK(!doc.hasOwnProperty("new"));
+
+  // edits through JSONVar drop the tables
+  doc["new"] = 11;
+  CHECK(doc.hasOwnProperty("new"));
+  CHECK_EQ(11, (int)doc["new"]);
+
+  doc["a"] = undefined;
+  CHECK(!doc.hasOwnProperty("a"));
+  CHECK(doc.hasOwnProperty("b"));
+
+  doc["b"] = "two";
+  CHECK_STR("two", (const char*)doc["b"]);
+  // filter() matches keys case-insensitively
+  CHECK(JSON.typeof(doc.filter("B", "two")) == "object");
+  CHECK(JSON.typeof(doc.filter("B", "three")) == "undefined");
+
+  // edits straight to the cJSON nodes need invalidate()
+  cJSON* object = makeObject(20);
+  CHECK(JSONIndex::find(object, "k3") != NULL);
+  CHECK(JSONIndex::find(object, "k3") != NULL);
+  cJSON_DeleteItemFromObjectCaseSensitive(object, "k3");
+  JSONIndex::invalidate();
+  CHECK(JSONIndex::find(object, "k3") == NULL);
+  CHECK(JSONIndex::find(object, "k4") != NULL);
+  cJSON_Delete(object);
+}
+
+TEST(more_objects_than_tables)
+{
+  cJSON* objects[JSON_INDEX_CACHE + 2];
+
+  for (int i = 0; i < JSON_INDEX_CACHE + 2; i++) {
+    objects[i] = makeObject(10 + i);
+  }
+
+  // round-robin over more objects than are cached at once
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < JSON_INDEX_CACHE + 2; i++) {
+      char key[16];
+
+      snprintf(key, sizeof(key), "k%d", 9 + i);
+      cJSON* found = JSONIndex::find(objects[i], key);
+      CHECK(found != NULL && found->valueint == 9 + i);
+      CHECK(JSONIndex::find(objects[i], key) == found);
+    }
+  }
+
+  JSONIndex::invalidate();
+  for (int i = 0; i < JSON_INDEX_CACHE + 2; i++) {
+    cJSON_Delete(objects[i]);
+  }
+}
+
+// Not a check: looking up every key of an n-key object through the index
+// against cJSON's scan, to see where the index starts to pay.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  static const int sizes[] = { 4, 8, 16, 32, 64, 256 };
+  volatile int sink = 0;
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(*sizes); s++) {
+    int n = sizes[s];
+    int rounds = 200000 / (n * n) + 10;
+    cJSON* object = makeObject(n);
+    std::string keys[256];
+
+    for (int i = 0; i < n; i++) {
+      keys[i] = "k" + std::to_string(i);
+    }
+
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (int i = 0; i < n; i++) {
+        sink = sink + (JSONIndex::find(object, keys[i].c_str()) != NULL);
+      }
+    }
+    Clock::time_point t1 = Clock::now();
+    for (int r = 0; r < rounds; r++) {
+      for (int i = 0; i < n; i++) {
+        sink = sink + (cJSON_GetObjectItemCaseSensitive(object, keys[i].c_str()) != NULL);
+      }
+    }
+    Clock::time_point t2 = Clock::now();
+
+    double lookups = (double)rounds * n;
+    printf("%3d keys: index %.1f ns, scan %.1f ns per lookup\n", n,
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / lookups,
+           std::chrono::duration<double, std::nano>(t2 - t1).count() / lookups);
+
+    JSONIndex::invalidate();
+    cJSON_Delete(object);
+  }
+}
@@ -0,0 +1,115 @@
+#include <string>
+
+#include <JSONPathScanner.h>
+
+#include "test.h"
+
+// lists each scalar as path=text
+class Collector : public JSONPathScanner {
+public:
+  std::string values;
+
+protected:
+  virtual void value(const char* path, const char* text, uint8_t type)
+  {
+    values += std::string(path) + "=" + text + (type == JSON_SCAN_STRING ? "$ " : " ");
+  }
+};
+
+static const char weather[] =
+  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},"
+  "\"weather\":[{\"id\":800,\"main\":\"Clear\"},{\"id\":701,\"main\":\"Mist\"}],"
+  "\"main\":{\"temp\":288.71,\"feels_like\":287.82,\"humidity\":58},"
+  "\"wind\":{\"speed\":4.12,\"deg\":250},\"rain\":null,\"name\":\"London\"}";
+
+static const char weatherValues[] =
+  "coord.lon=-0.1257 coord.lat=51.5085 "
+  "weather[0].id=800 weather[0].main=Clear$ weather[1].id=701 weather[1].main=Mist$ "
+  "main.temp=288.71 main.feels_like=287.82 main.humidity=58 "
+  "wind.speed=4.12 wind.deg=250 rain=null name=London$ ";
+
+TEST(paths)
+{
+  Collector scanner;
+
+  scanner.print(weather);
+  CHECK(scanner.finished());
+  CHECK_STR(weatherValues, scanner.values.c_str());
+
+  Collector arrays;
+  arrays.print("[[1,2],[],[[true]],{\"a\":[false]}]");
+  CHECK(arrays.finished());
+  CHECK_STR("[0][0]=1 [0][1]=2 [2][0][0]=true [3].a[0]=false ", arrays.values.c_str());
+}
+
+TEST(chunked)
+{
+  for (size_t chunk = 1; chunk < sizeof(weather); chunk++) {
+    Collector scanner;
+
+    for (size_t i = 0; i < sizeof(weather) - 1; i += chunk) {
+      size_t n = sizeof(weather) - 1 - i < chunk ? sizeof(weather) - 1 - i : chunk;
+      scanner.write((const uint8_t*)weather + i, n);
+    }
+    CHECK_STR(weatherValues, scanner.values.c_str());
+  }
+}
+
+TEST(paths_that_do_not_fit_are_skipped)
+{
+  Collector scanner;
+  std::string longKey(JSON_PATH_MAX, 'k');
+
+  // "a." + 48 characters is too long; its siblings and what follows are not
+  scanner.print(("{\"a\":{\"" + longKey + "\":{\"x\":1},\"b\":2},\"c\":[3]}").c_str());
+  CHECK(scanner.finished());
+  CHECK_STR("a.b=2 c[0]=3 ", scanner.values.c_str());
+
+  // nor is a key the parser had to cut short, even at the top level
+  Collector cut;
+  std::string cutKey(JSON_SAX_TEXT_MAX + 1, 'q');
+  cut.print(("{\"" + cutKey + "\":1,\"ok\":2}").c_str());
+  CHECK_STR("ok=2 ", cut.values.c_str());
+}
+
+TEST(too_deep)
+{
+  Collector scanner;
+  std::string deep(JSON_SCAN_DEPTH + 1, '[');
+
+  scanner.print(deep.c_str());
+  CHECK(scanner.failed());
+  CHECK_EQ(JSON_SAX_REJECTED, scanner.error());
+}
+
+TEST(extractor_stops_once_everything_is_found)
+{
+  const char* paths[] = { "main.temp", "main.humidity", "wind.speed" };
+  double values[3] = { 0, 0, 0 };
+  JSONPathExtractor fields(paths, values, 3);
+
+  // everything after "wind.speed" is garbage that must not be parsed
+  std::string reply = std::string(weather, strstr(weather, "\"deg\"")) + "}}} not json";
+  fields.print(reply.c_str());
+
+  CHECK(fields.complete());
+  CHECK(!fields.scanning());
+  CHECK(!fields.failed());
+  CHECK(values[0] == 288.71);
+  CHECK(values[1] == 58);
+  CHECK(values[2] == 4.12);
+
+  // strings don't count, and the scan runs to the end when a field is missing
+  const char* missing[] = { "name", "main.pressure" };
+  JSONPathExtractor partial(missing, values, 2);
+  partial.print(weather);
+  CHECK(partial.finished());
+  CHECK(!partial.found(0));
+  CHECK(!partial.found(1));
+  CHECK(!partial.complete());
+
+  partial.reset();
+  partial.print("{\"main\":{\"pressure\":1019}}");
+  CHECK(partial.found(1));
+  CHECK(values[1] == 1019);
+}
@@ -0,0 +1,101 @@
+#include <Arduino_JSON.h>
+
+#include "cjson/cJSON.h"
+
+#include "test.h"
+
+static unsigned int allocations;
+
+static void* countingMalloc(size_t size)
+{
+  allocations++;
+  return malloc(size);
+}
+
+static struct cJSON_Hooks countingHooks = { countingMalloc, free };
+
+static const char weather[] =
+  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},"
+  "\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"clear sky\"}],"
+  "\"main\":{\"temp\":288.71,\"humidity\":58},\"rain\":null,\"snow\":false,\"name\":\"London\"}";
+
+TEST(lookups)
+{
+  JSONVar doc = JSON.parse(weather);
+  JSONRef root(doc);
+
+  CHECK(doc.get("main").get("temp").asDouble() == 288.71);
+  CHECK_EQ(58, root["main"]["humidity"].asInt());
+  CHECK_EQ(800, root.get("weather").get(0).get("id").asInt());
+  CHECK_STR("clear sky", root["weather"][0]["description"].asString());
+  CHECK_STR("London", root.get(String("name")).asString());
+  CHECK(!root["snow"].asBool(true));
+
+  CHECK(root["rain"].exists());
+  CHECK(root["rain"].isNull());
+  CHECK(root["snow"].isBool());
+  CHECK(root["main"]["temp"].isNumber());
+  CHECK(root["name"].isString());
+  CHECK(root["weather"].isArray());
+  CHECK(root["coord"].isObject());
+
+  CHECK_EQ(6, root.length());
+  CHECK_EQ(1, root["weather"].length());
+  CHECK_EQ(6, root["name"].length());
+  CHECK_EQ(-1, root["main"]["temp"].length());
+}
+
+TEST(missing_values_give_the_fallback)
+{
+  JSONVar doc = JSON.parse(weather);
+  JSONRef root(doc);
+
+  // a chain through missing members and wrong types needs no checks
+  JSONRef missing = root["main"]["pressure"]["x"][3];
+  CHECK(!missing.exists());
+  CHECK(!missing.isNull());
+  CHECK(missing.asDouble(-1) == -1);
+  CHECK(isnan(missing.asDouble()));
+  CHECK_EQ(7, missing.asInt(7));
+  CHECK(missing.asBool(true));
+  CHECK(missing.asString() == NULL);
+  CHECK_STR("none", missing.asString("none"));
+  CHECK_EQ(-1, missing.length());
+
+  CHECK(!root["weather"][1].exists());
+  CHECK(!root["weather"][-1].exists());
+  CHECK(!root["name"][0].exists());
+  CHECK(!root[0].exists());
+  CHECK(!root["weather"]["id"].exists());
+
+  // wrong types give the fallback as well
+  CHECK_EQ(5, root["name"].asInt(5));
+  CHECK(root["main"]["temp"].asString() == NULL);
+  CHECK(!JSONRef().exists());
+}
+
+TEST(lookups_do_not_allocate_or_add_members)
+{
+  JSONVar doc = JSON.parse(weather);
+  String before = JSON.stringify(doc);
+
+  JSONArena::setHooks(&countingHooks);
+  allocations = 0;
+
+  JSONRef root(doc);
+  for (int i = 0; i < 10; i++) {
+    root["main"]["temp"].asDouble();
+    root["weather"][0]["main"].asString();
+    root["main"]["pressure"].asInt();
+    root["nothing"]["here"].exists();
+  }
+  CHECK_EQ(0, allocations);
+
+  // unlike operator[], which adds what is missing
+  (void)doc["nothing"];
+  CHECK(allocations > 0);
+  JSONArena::setHooks(NULL);
+
+  CHECK_STR((before.substring(0, before.length() - 1) + ",\"nothing\":null}").c_str(),
+            JSON.stringify(doc).c_str());
+}
@@ -0,0 +1,263 @@
+#include <stdlib.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <JSONSaxParser.h>
+
+#include "test.h"
+
+// writes each event as a token, e.g. {k:a n:1 [s:x t]}
+class Recorder : public JSONSaxParser {
+public:
+  std::string events;
+  const char* stopAtKey = NULL;
+  const char* failAtKey = NULL;
+
+protected:
+  virtual void onStartObject() { events += "{"; }
+  virtual void onEndObject() { events += "}"; }
+  virtual void onStartArray() { events += "["; }
+  virtual void onEndArray() { events += "]"; }
+  virtual void onKey(const char* key)
+  {
+    events += std::string("k:") + key + (truncated() ? "... " : " ");
+    if (stopAtKey && strcmp(key, stopAtKey) == 0) {
+      stop();
+    }
+    if (failAtKey && strcmp(key, failAtKey) == 0) {
+      fail();
+    }
+  }
+  virtual void onString(const char* value) { events += std::string("s:") + value + (truncated() ? "... " : " "); }
+  virtual void onNumber(const char* text) { events += std::string("n:") + text + " "; }
+  virtual void onBool(bool value) { events += value ? "t " : "f "; }
+  virtual void onNull() { events += "z "; }
+};
+
+static const char weather[] =
+  "{\"coord\":{\"lon\":-0.1257,\"lat\":51.5085},"
+  "\"weather\":[{\"id\":800,\"main\":\"Clear\",\"description\":\"clear sky\"}],"
+  "\"main\":{\"temp\":288.71,\"humidity\":58},\"visibility\":10000,"
+  "\"rain\":null,\"snow\":false,\"name\":\"London\"}";
+
+static const char weatherEvents[] =
+  "{k:coord {k:lon n:-0.1257 k:lat n:51.5085 }"
+  "k:weather [{k:id n:800 k:main s:Clear k:description s:clear sky }]"
+  "k:main {k:temp n:288.71 k:humidity n:58 }k:visibility n:10000 "
+  "k:rain z k:snow f k:name s:London }";
+
+// error() after feeding all of text in one write
+static uint8_t errorOf(const char* text)
+{
+  Recorder parser;
+
+  parser.print(text);
+  return parser.error();
+}
+
+TEST(events)
+{
+  Recorder parser;
+
+  parser.print(weather);
+  CHECK(parser.finished());
+  CHECK(!parser.failed());
+  CHECK_EQ(0, parser.depth());
+  CHECK_STR(weatherEvents, parser.events.c_str());
+}
+
+TEST(chunk_split_invariance)
+{
+  // every chunk size from single bytes up gives the same events
+  for (size_t chunk = 1; chunk <= sizeof(weather); chunk++) {
+    Recorder parser;
+
+    for (size_t i = 0; i < sizeof(weather) - 1; i += chunk) {
+      size_t n = sizeof(weather) - 1 - i < chunk ? sizeof(weather) - 1 - i : chunk;
+      CHECK_EQ(n, parser.write((const uint8_t*)weather + i, n));
+    }
+    CHECK(parser.finished());
+    CHECK_STR(weatherEvents, parser.events.c_str());
+  }
+}
+
+// the events, error and state after feeding text in pieces cut at the
+// given offsets, some pieces byte by byte
+static std::string splitResult(const std::string& text, const std::vector<size_t>& cuts)
+{
+  Recorder parser;
+  size_t from = 0;
+
+  for (size_t i = 0; i <= cuts.size(); i++) {
+    size_t to = i < cuts.size() ? cuts[i] : text.size();
+    if (i & 1) {
+      for (size_t j = from; j < to; j++) {
+        if (parser.write((uint8_t)text[j]) != 1) {
+          return "short write";
+        }
+      }
+    } else if (parser.write((const uint8_t*)text.data() + from, to - from) != to - from) {
+      return "short write";
+    }
+    from = to;
+  }
+
+  char state[32];
+  snprintf(state, sizeof(state), " error %u %s", parser.error(),
+           parser.finished() ? "finished" : parser.parsing() ? "parsing" : "stopped");
+  return parser.events + state;
+}
+
+TEST(random_splits)
+{
+  static const char* const fixed[] = {
+    weather,
+    "[\"a\\\"b\\\\c\\/d\\n\", \"\\u00e9\\u20ac\\ud83d\\ude00\", 0, -0, 1e5, -2.5E-3, true, null, [], {}]",
+    "{\"a\":[1,2,{\"b\":[]}],\"c\":\"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx\"} ",
+    "[1.5e+3, -0.0, 123456789012345678901234567890123]",
+    "[1,]", "{\"a\" 1}", "{\"a\":tru}", "[1 2]", "\"\\uD83D\\u0041\"", "[01]", "[-]", "{\"a\":1]",
+    "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]",
+    "42",
+    "{} trailing",
+  };
+  static const char damage[] = "{}[]\",:\\0-e.tnx ";
+  std::vector<std::string> samples(fixed, fixed + sizeof(fixed) / sizeof(*fixed));
+
+  // the weather reply cut short, and with one byte damaged
+  srand(7);
+  for (int i = 0; i < 10; i++) {
+    samples.push_back(std::string(weather, rand() % (sizeof(weather) - 1)));
+    std::string damaged(weather);
+    damaged[rand() % damaged.size()] = damage[rand() % (sizeof(damage) - 1)];
+    samples.push_back(damaged);
+  }
+
+  unsigned int malformed = 0;
+  for (size_t s = 0; s < samples.size(); s++) {
+    const std::string& text = samples[s];
+    std::string whole = splitResult(text, std::vector<size_t>());
+
+    if (whole.find(" error 0 ") == std::string::npos) {
+      malformed++;
+    }
+    for (int round = 0; round < 2000; round++) {
+      std::vector<size_t> cuts;
+      size_t pieces = rand() % 8;
+      for (size_t i = 0; i < pieces; i++) {
+        cuts.push_back(text.empty() ? 0 : rand() % (text.size() + 1));
+      }
+      std::sort(cuts.begin(), cuts.end());
+
+      std::string split = splitResult(text, cuts);
+      if (split != whole) {
+        printf("split of %s differs:\n  %s\n  %s\n", text.c_str(), whole.c_str(), split.c_str());
+        testFailures++;
+        break;
+      }
+    }
+  }
+  CHECK(malformed >= 10);
+}
+
+TEST(scalars_and_escapes)
+{
+  Recorder parser;
+
+  parser.print("[\"a\\\"b\\\\c\\/d\\n\", \"\\u00e9\\u20ac\\ud83d\\ude00\", 0, -0, 1e5, -2.5E-3, true, null, [], {}]");
+  CHECK(parser.finished());
+  CHECK_STR("[s:a\"b\\c/d\n s:\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80 n:0 n:-0 n:1e5 n:-2.5E-3 t z []{}]",
+            parser.events.c_str());
+
+  // a number at the top level ends at the first byte that can't continue it
+  Recorder number;
+  number.print("42");
+  CHECK(number.parsing());
+  number.print(" ");
+  CHECK(number.finished());
+  CHECK_STR("n:42 ", number.events.c_str());
+}
+
+TEST(long_text)
+{
+  Recorder parser;
+  std::string longText(JSON_SAX_TEXT_MAX + 8, 'x');
+  std::string fits(JSON_SAX_TEXT_MAX, 'y');
+
+  parser.print(("{\"" + longText + "\":\"" + fits + "\"}").c_str());
+  CHECK(parser.finished());
+  std::string expected = "{k:" + longText.substr(0, JSON_SAX_TEXT_MAX) + "... s:" + fits + " }";
+  CHECK_STR(expected.c_str(), parser.events.c_str());
+
+  // a number can't be cut short without changing its value
+  std::string digits(JSON_SAX_TEXT_MAX, '1');
+  CHECK_EQ(JSON_SAX_OK, errorOf(("[" + digits + "]").c_str()));
+  CHECK_EQ(JSON_SAX_TOO_LONG, errorOf(("[" + digits + "1]").c_str()));
+}
+
+TEST(syntax_errors)
+{
+  static const char* samples[] = {
+    "]", "}", "[1,]", "[,1]", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "{\"a\"}", "[1 2]", "[1}", "{\"a\":1]",
+    "tru ", "nul ", "falsey ", "\"\\x\"", "\"\\u12x4\"", "\"tab\there\"",
+    "-.5 ", ".5 ", "+1 ", "01 ", "[1.]", "1e ", "[1.2.3]", "[-]", "[0x10]",
+    "\"\\u0000\"", "\"\\uDC00\"", "\"\\uD83D\"", "\"\\uD83Dx\"", "\"\\uD83D\\n\"", "\"\\uD83D\\u0041\"",
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    if (errorOf(samples[i]) != JSON_SAX_SYNTAX) {
+      printf("not a syntax error: %s\n", samples[i]);
+      testFailures++;
+    }
+  }
+}
+
+TEST(depth_limit)
+{
+  std::string deep(JSON_SAX_DEPTH, '[');
+  deep += std::string(JSON_SAX_DEPTH, ']');
+  CHECK_EQ(JSON_SAX_OK, errorOf(deep.c_str()));
+
+  std::string tooDeep(JSON_SAX_DEPTH + 1, '[');
+  CHECK_EQ(JSON_SAX_TOO_DEEP, errorOf(tooDeep.c_str()));
+}
+
+TEST(stop_and_fail)
+{
+  Recorder stopped;
+  stopped.stopAtKey = "weather";
+  stopped.print(weather);
+  CHECK(!stopped.parsing());
+  CHECK(!stopped.finished());
+  CHECK(!stopped.failed());
+  CHECK_STR("{k:coord {k:lon n:-0.1257 k:lat n:51.5085 }k:weather ", stopped.events.c_str());
+
+  Recorder rejected;
+  rejected.failAtKey = "main";
+  rejected.print(weather);
+  CHECK(rejected.failed());
+  CHECK_EQ(JSON_SAX_REJECTED, rejected.error());
+
+  // bytes after the end are accepted and ignored
+  Recorder after;
+  after.print("{} trailing");
+  CHECK(after.finished());
+  CHECK_EQ(3, after.write((const uint8_t*)"xyz", 3));
+  CHECK(after.finished());
+}
+
+TEST(reset)
+{
+  Recorder parser;
+
+  parser.print("[1,");
+  parser.print("}");
+  CHECK_EQ(JSON_SAX_SYNTAX, parser.error());
+
+  parser.reset();
+  parser.events.clear();
+  parser.print("[true]");
+  CHECK(parser.finished());
+  CHECK_EQ(JSON_SAX_OK, parser.error());
+  CHECK_STR("[t ]", parser.events.c_str());
+}
@@ -0,0 +1,296 @@
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+
+#include <Arduino_JSON.h>
+#include <JSONWriter.h>
+
+#include "cjson/cJSON.h"
+
+#include "test.h"
+
+// collects what is printed to it
+class StringPrint : public Print {
+public:
+  virtual size_t write(uint8_t c) { text += (char)c; return 1; }
+  using Print::write;
+  std::string text;
+};
+
+static unsigned int allocations;
+
+static void* countingMalloc(size_t size)
+{
+  allocations++;
+  return malloc(size);
+}
+
+static std::string written(double d)
+{
+  StringPrint out;
+  JSONWriter json(out);
+
+  json.value(d);
+  CHECK_EQ(out.text.size(), json.written());
+  return out.text;
+}
+
+static std::string printed(double d)
+{
+  cJSON* number = cJSON_CreateNumber(d);
+  char* text = cJSON_PrintUnformatted(number);
+  std::string s(text);
+
+  cJSON_free(text);
+  cJSON_Delete(number);
+  return s;
+}
+
+// the writer gives cJSON's text wherever cJSON's text reads back exactly,
+// and text that reads back exactly everywhere else
+static void checkNumber(double d)
+{
+  std::string actual = written(d);
+  std::string expected = printed(d);
+
+  if (strtod(expected.c_str(), NULL) == d) {
+    CHECK_STR(expected.c_str(), actual.c_str());
+  } else {
+    CHECK(strtod(actual.c_str(), NULL) == d);
+  }
+}
+
+TEST(numbers_as_cJSON_prints_them)
+{
+  static const double samples[] = {
+    0, -0.0, 1, -1, 58, 288.71, -0.1257, 51.5085, 0.1, 1.0 / 3, 2.5e-3, 1e-7, 123456789,
+    999999999, 1e9, 2147483647, 2147483648.0, -2147483648.0, 3e9, 1e15, 1e16, 1e17, 1e21,
+    12345678901234567890.0, 0.30000000000000004, 4.9e-324, 1.7976931348623157e308, 1747627268,
+  };
+
+  for (size_t i = 0; i < sizeof(samples) / sizeof(*samples); i++) {
+    checkNumber(samples[i]);
+  }
+
+  srand(2);
+  for (int i = 0; i < 20000; i++) {
+    double mantissa = (double)rand() / RAND_MAX - 0.5;
+    checkNumber(ldexp(mantissa, rand() % 200 - 100));
+    checkNumber((double)(rand() % 2000000 - 1000000) / 100);
+  }
+
+  CHECK_STR("null", written(NAN).c_str());
+  CHECK_STR("null", written(INFINITY).c_str());
+  CHECK_STR("null", written(-INFINITY).c_str());
+}
+
+TEST(fixed_decimals)
+{
+  StringPrint out;
+  JSONWriter json(out);
+
+  json.beginArray().value(23.456, 1).value(-0.05, 2).value(7.0, 0).value(NAN, 2).endArray();
+  CHECK_STR("[23.5,-0.05,7,null]", out.text.c_str());
+}
+
+TEST(structure_and_escaping)
+{
+  StringPrint out;
+  JSONWriter json(out);
+
+  json.beginObject()
+      .member("rpm", 1200)
+      .member("on", true)
+      .member("name", "fan \"one\"\\\n\t\x01\x1f/\xC3\xA9")
+      .member("tempC", 23.456, 1)
+      .key("fans").beginArray().value(1).value(2u).value(-3L).value(4UL).endArray()
+      .key("empty").beginObject().endObject()
+      .key("none").valueNull()
+      .key("nested").beginArray().beginArray().endArray().beginObject().endObject().endArray()
+      .key("raw").valueRaw("{\"a\":[1,2]}")
+      .key("s").value(String("str"))
+      .key("nothing").value((const char*)NULL)
+    .endObject();
+
+  const char* expected =
+    "{\"rpm\":1200,\"on\":true,\"name\":\"fan \\\"one\\\"\\\\\\n\\t\\u0001\\u001f/\xC3\xA9\","
+    "\"tempC\":23.5,\"fans\":[1,2,-3,4],\"empty\":{},\"none\":null,\"nested\":[[],{}],"
+    "\"raw\":{\"a\":[1,2]},\"s\":\"str\",\"nothing\":null}";
+  CHECK_STR(expected, out.text.c_str());
+  CHECK_EQ(strlen(expected), json.written());
+
+  // the same document as JSON.stringify() of the tree
+  JSONVar doc = JSON.parse(out.text.c_str());
+  CHECK(JSON.typeof(doc) == "object");
+  CHECK_STR(JSON.stringify(doc).c_str(), out.text.c_str());
+}
+
+TEST(stringify_matches)
+{
+  JSONVar doc;
+
+  doc["temp"] = 288.71;
+  doc["humidity"] = 58;
+  doc["speed"] = 4.12;
+  doc["name"] = "Lon\"don\n";
+  doc["ok"] = false;
+  doc["list"][0] = 0.1;
+  doc["list"][1] = -1e-7;
+
+  StringPrint out;
+  JSONWriter json(out);
+  json.beginObject()
+      .member("temp", 288.71)
+      .member("humidity", 58)
+      .member("speed", 4.12)
+      .member("name", "Lon\"don\n")
+      .member("ok", false)
+      .key("list").beginArray().value(0.1).value(-1e-7).endArray()
+    .endObject();
+
+  CHECK_STR(JSON.stringify(doc).c_str(), out.text.c_str());
+}
+
+TEST(deeper_than_tracked)
+{
+  StringPrint out;
+  JSONWriter json(out);
+
+  for (int i = 0; i < JSON_WRITER_DEPTH; i++) {
+    json.beginArray();
+  }
+  json.value(1).value(2);
+  for (int i = 0; i < JSON_WRITER_DEPTH; i++) {
+    json.endArray();
+  }
+  json.beginArray().value(3).endArray();
+
+  std::string expected = std::string(JSON_WRITER_DEPTH, '[') + "1,2" + std::string(JSON_WRITER_DEPTH, ']') + "[3]";
+  CHECK_STR(expected.c_str(), out.text.c_str());
+}
+
+TEST(buffer_overflow)
+{
+  char storage[16];
+  JSONBuffer buffer(storage, sizeof(storage));
+  JSONWriter json(buffer);
+
+  json.beginObject().member("a", 1).endObject();
+  CHECK_STR("{\"a\":1}", buffer.c_str());
+  CHECK_EQ(7, buffer.length());
+  CHECK(!buffer.overflowed());
+
+  // output that doesn't fit is dropped, and the text stays terminated
+  json.beginArray().value("a long string").endArray();
+  CHECK(buffer.overflowed());
+  CHECK_EQ(15, buffer.length());
+  CHECK_STR("{\"a\":1}[\"a long", buffer.c_str());
+  CHECK_EQ(15, json.written());
+
+  buffer.clear();
+  CHECK(!buffer.overflowed());
+  CHECK_STR("", buffer.c_str());
+
+  // byte by byte as well
+  for (int i = 0; i < 20; i++) {
+    buffer.write((uint8_t)'x');
+  }
+  CHECK(buffer.overflowed());
+  CHECK_EQ(15, buffer.length());
+  CHECK_EQ(15, strlen(storage));
+
+  // an empty buffer takes nothing
+  JSONBuffer none(NULL, 0);
+  CHECK_EQ(0, none.write((uint8_t)'x'));
+  CHECK_EQ(0, none.write((const uint8_t*)"xy", 2));
+  CHECK(none.overflowed());
+}
+
+// a status document as the fan would send it
+static void writeStatus(JSONWriter& json)
+{
+  json.beginObject()
+      .member("tempC", 23.456, 1)
+      .member("humidity", 58)
+      .member("rpm", 1200)
+      .member("mode", "auto")
+      .member("on", true)
+      .key("fans").beginArray().value(1200).value(1180).value(0).endArray()
+      .key("weather").beginObject()
+        .member("temp", 288.71)
+        .member("pressure", 1019)
+        .member("wind", 4.12)
+      .endObject()
+    .endObject();
+}
+
+// neither the writer nor JSONVar::printTo() touch the heap
+TEST(no_allocations)
+{
+  struct cJSON_Hooks hooks = { countingMalloc, free };
+  char storage[256];
+  JSONBuffer buffer(storage, sizeof(storage));
+  JSONWriter json(buffer);
+
+  writeStatus(json);
+  JSONVar doc = JSON.parse(storage);
+  CHECK(JSON.typeof(doc) == "object");
+
+  JSONArena::setHooks(&hooks);
+  allocations = 0;
+  buffer.clear();
+  JSONWriter again(buffer);
+  writeStatus(again);
+  CHECK_EQ(0, allocations);
+
+  JSONBuffer printed(storage, sizeof(storage));
+  size_t length = doc.printTo(printed);
+  CHECK_EQ(0, allocations);
+  CHECK_EQ(strlen(storage), length);
+  CHECK(!printed.overflowed());
+  JSONArena::setHooks(NULL);
+
+  CHECK_STR(JSON.stringify(doc).c_str(), storage);
+}
+
+// Not a check: output rate of the writer, of JSONVar::printTo() and of
+// JSON.stringify() for the status document, on this machine.
+TEST(benchmark)
+{
+  typedef std::chrono::steady_clock Clock;
+  char storage[256];
+  JSONBuffer buffer(storage, sizeof(storage));
+  const int n = 100000;
+  size_t bytes = 0;
+
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < n; i++) {
+    buffer.clear();
+    JSONWriter json(buffer);
+    writeStatus(json);
+    bytes += json.written();
+  }
+  Clock::time_point t1 = Clock::now();
+
+  JSONVar doc = JSON.parse(storage);
+  size_t printedBytes = 0;
+  for (int i = 0; i < n; i++) {
+    buffer.clear();
+    printedBytes += doc.printTo(buffer);
+  }
+  Clock::time_point t2 = Clock::now();
+
+  size_t stringifiedBytes = 0;
+  for (int i = 0; i < n; i++) {
+    stringifiedBytes += JSON.stringify(doc).length();
+  }
+  Clock::time_point t3 = Clock::now();
+
+  CHECK_EQ(bytes, printedBytes);
+  CHECK_EQ(bytes, stringifiedBytes);
+  printf("%u byte document: writer %.1f MB/s, printTo %.1f MB/s, stringify %.1f MB/s\n",
+         (unsigned)(bytes / n),
+         bytes / std::chrono::duration<double, std::micro>(t1 - t0).count(),
+         bytes / std::chrono::duration<double, std::micro>(t2 - t1).count(),
+         bytes / std::chrono::duration<double, std::micro>(t3 - t2).count());
+}
@@ -0,0 +1,152 @@
+#include <LiquidCrystal.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+// Display 1's wiring in the sketch: RS 6, E 7, D4..D7 8..11
+#define RS 6
+#define EN 7
+
+TEST(four_bit_init_and_text)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+
+  lcd.begin(16, 2);
+  CHECK(!panel.eightBit());
+  CHECK(panel.twoLines());
+  CHECK_EQ(0x04, panel.displayControl());  // on, no cursor, no blink
+  CHECK_EQ(0x02, panel.entryMode());       // left to right, no shift
+
+  lcd.print("Fan: 75%");
+  lcd.setCursor(0, 1);
+  lcd.print("Mode: Auto");
+  CHECK_STR("Fan: 75%        ", panel.row(0).c_str());
+  CHECK_STR("Mode: Auto      ", panel.row(1).c_str());
+
+  // clear() waits out its 1.52 ms before the next byte
+  lcd.clear();
+  lcd.print(23.4, 1);
+  CHECK_STR("23.4            ", panel.row(0).c_str());
+  CHECK_STR("                ", panel.row(1).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+// the constructor already ran begin(16, 1), so begin() has to bring a
+// controller that is in 4-bit mode back in step
+TEST(begin_again_resynchronises)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+
+  lcd.begin(16, 2);
+  lcd.print("first");
+  lcd.begin(20, 4);
+  lcd.setCursor(0, 3);
+  lcd.print("fourth row");
+  CHECK_STR("fourth row          ", panel.row(3, 20).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+TEST(eight_bit_wiring)
+{
+  HD44780 panel(RS, 12, EN, 30, 31, 32, 33, 34, 35, 36, 37);
+  LiquidCrystal lcd(RS, 12, EN, 30, 31, 32, 33, 34, 35, 36, 37);
+
+  lcd.begin(16, 2);
+  CHECK(panel.eightBit());
+  lcd.setCursor(3, 1);
+  lcd.print("8 bits");
+  CHECK_STR("   8 bits       ", panel.row(1).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+TEST(custom_characters_and_entry_mode)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  uint8_t degree[8] = { 0x0C, 0x12, 0x12, 0x0C, 0x00, 0x00, 0x00, 0x00 };
+
+  lcd.begin(16, 2);
+  lcd.createChar(1, degree);
+  CHECK(memcmp(degree, panel.glyph(1), 8) == 0);
+
+  // createChar() leaves the address counter in CGRAM until setCursor()
+  lcd.setCursor(4, 0);
+  lcd.write(1);
+  CHECK_EQ(1, panel.text(4, 1)[0]);
+
+  lcd.rightToLeft();
+  lcd.setCursor(10, 1);
+  lcd.print("abc");
+  CHECK_STR("cba", panel.text(0x40 + 8, 3).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+// Not a check: the host takes the digitalWrite() path, so this is the
+// time a character spends on the bus, not the AVR port write cost.
+TEST(time_per_character)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+
+  lcd.begin(16, 2);
+  host_time_t start = hostNow();
+  lcd.print("0123456789ABCDEF");
+  host_time_t perChar = (hostNow() - start) / 16;
+
+  printf("%u us per character\n", (unsigned)perChar);
+  CHECK(perChar >= HD44780_EXEC_US);
+  CHECK_EQ(16, panel.characters);
+}
+
+// with RW wired the controller is asked when it is ready, so each byte
+// goes out as soon as the previous one has run, however long that takes
+TEST(busy_polling_returns_when_ready)
+{
+  HD44780 panel(RS, 12, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, 12, EN, 8, 9, 10, 11);
+
+  lcd.begin(16, 2);
+  lcd.setBusyPolling(true);
+
+  host_time_t start = hostNow();
+  lcd.print("0123456789ABCDEF");
+  host_time_t perChar = (hostNow() - start) / 16;
+  CHECK_STR("0123456789ABCDEF", panel.row(0).c_str());
+  CHECK(perChar >= HD44780_EXEC_US);
+  CHECK(perChar < HD44780_EXEC_US + 20);
+
+  // clear() is over once the controller says so, not after a fixed 2 ms
+  lcd.clear();
+  start = hostNow();
+  lcd.write('x');
+  CHECK(hostNow() - start >= HD44780_LONG_EXEC_US);
+  CHECK(hostNow() - start < 2000);
+  CHECK_STR("x", panel.text(0, 1).c_str());
+
+  // a slow controller is waited for just as long as it needs
+  panel.timePercent = 145;
+  lcd.setCursor(0, 1);
+  lcd.print("slow clock");
+  CHECK_STR("slow clock      ", panel.row(1).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+// a controller that never comes ready costs LCD_BUSY_TIMEOUT per byte
+TEST(busy_polling_gives_up_on_a_dead_display)
+{
+  HD44780 panel(RS, 12, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, 12, EN, 8, 9, 10, 11);
+
+  lcd.begin(16, 2);
+  lcd.setBusyPolling(true);
+  panel.hung = true;
+
+  host_time_t start = hostNow();
+  lcd.write('x');
+  host_time_t waited = hostNow() - start;
+  CHECK(waited >= LCD_BUSY_TIMEOUT);
+  CHECK(waited < LCD_BUSY_TIMEOUT + 50);
+  CHECK_EQ(1, panel.characters);
+}
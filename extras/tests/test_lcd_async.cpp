@@ -0,0 +1,122 @@
+#include <stdlib.h>
+
+#include <LiquidCrystal.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+#define RS 6
+#define EN 7
+#define QUEUE 80
+
+// the timer interrupt sometimes held off by another one for up to a tick
+static void lateTick()
+{
+  LiquidCrystal::asyncTick();
+  hostTimerLate(rand() % LCD_ASYNC_TICK_US);
+}
+
+// idle() doesn't read the clock with a timer behind the queue, so move it
+static bool drain(LiquidCrystal& lcd)
+{
+  for (int i = 0; i < 10000; i++) {
+    if (lcd.idle()) {
+      return true;
+    }
+    hostAdvance(LCD_ASYNC_TICK_US);
+  }
+  return false;
+}
+
+TEST(text_through_the_timer)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  uint16_t queue[QUEUE];
+
+  lcd.begin(16, 2);
+  CHECK(lcd.beginAsync(queue, QUEUE));
+  hostTimer(LiquidCrystal::asyncTick, LCD_ASYNC_TICK_US);
+
+  // printing only queues
+  host_time_t start = hostNow();
+  lcd.print("Fan: 75%");
+  lcd.setCursor(0, 1);
+  lcd.print("Mode: Auto");
+  CHECK(hostNow() - start < LCD_ASYNC_TICK_US);
+  CHECK_EQ(19, lcd.queueDepth());
+
+  CHECK(drain(lcd));
+  CHECK_STR("Fan: 75%        ", panel.row(0).c_str());
+  CHECK_STR("Mode: Auto      ", panel.row(1).c_str());
+
+  // clear() is waited out by the interrupt, not by the caller
+  lcd.clear();
+  lcd.print("cleared");
+  CHECK(drain(lcd));
+  CHECK_STR("cleared         ", panel.row(0).c_str());
+  CHECK_EQ(0, panel.overruns);
+
+  lcd.endAsync();
+  lcd.print("!");
+  CHECK_STR("cleared!        ", panel.row(0).c_str());
+  hostTimer(NULL, 0);
+}
+
+// with ticks running up to a tick late and the controller at its slowest
+// rated clock (~53 us a command) nothing is latched while it is busy
+TEST(late_ticks_and_a_slow_controller)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  uint16_t queue[QUEUE];
+
+  lcd.begin(16, 2);
+  panel.timePercent = 145;
+  CHECK(lcd.beginAsync(queue, QUEUE));
+  srand(5);
+  hostTimer(lateTick, LCD_ASYNC_TICK_US);
+  unsigned long before = panel.executed;
+
+  for (int round = 0; round < 50; round++) {
+    lcd.setCursor(0, round & 1);
+    lcd.print("0123456789ABCDEF");
+    CHECK(drain(lcd));
+  }
+  CHECK_STR("0123456789ABCDEF", panel.row(1).c_str());
+  CHECK_EQ(50 * 17, panel.executed - before);
+  CHECK_EQ(0, panel.overruns);
+
+  lcd.endAsync();
+  hostTimer(NULL, 0);
+}
+
+// several displays share the one timer (each on its own lines: a tick
+// changes the bus while another display's enable is still high)
+TEST(two_displays_on_one_timer)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  HD44780 panel2(14, 12, 30, 31, 32, 33);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd2(14, 12, 30, 31, 32, 33);
+  uint16_t queue[QUEUE];
+  uint16_t queue2[QUEUE];
+
+  lcd.begin(16, 2);
+  lcd2.begin(16, 2);
+  CHECK(lcd.beginAsync(queue, QUEUE));
+  CHECK(lcd2.beginAsync(queue2, QUEUE));
+  hostTimer(LiquidCrystal::asyncTick, LCD_ASYNC_TICK_US);
+
+  lcd.print("first");
+  lcd2.print("second");
+  CHECK(drain(lcd));
+  CHECK(drain(lcd2));
+  CHECK_STR("first           ", panel.row(0).c_str());
+  CHECK_STR("second          ", panel2.row(0).c_str());
+  CHECK_EQ(0, panel.overruns + panel2.overruns);
+
+  lcd.endAsync();
+  lcd2.endAsync();
+  hostTimer(NULL, 0);
+}
@@ -0,0 +1,175 @@
+#include <LiquidCrystal.h>
+#include <LiquidCrystalGlyphs.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+#define RS 6
+#define EN 7
+
+// a bitmap that differs for every n
+static void pattern(uint8_t n, uint8_t bitmap[8])
+{
+  for (uint8_t row = 0; row < 8; row++) {
+    bitmap[row] = row;
+  }
+  bitmap[0] = n & 0x1F;
+  bitmap[1] = n >> 5;
+}
+
+TEST(reuse_without_reupload)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  LiquidCrystalGlyphs glyphs(lcd);
+  uint8_t arrow[8];
+
+  lcd.begin(16, 2);
+  pattern(1, arrow);
+
+  // a set-CGRAM-address command and 8 rows
+  unsigned long before = panel.executed;
+  uint8_t code = glyphs.acquire(arrow);
+  CHECK(code < LCD_GLYPH_SLOTS);
+  CHECK_EQ(9, panel.executed - before);
+  CHECK_EQ(0, memcmp(arrow, panel.glyph(code), 8));
+  CHECK_EQ(1, glyphs.uploads());
+
+  // the same bitmap again, pinned or not, costs nothing on the bus
+  before = panel.executed;
+  CHECK_EQ(code, glyphs.acquire(arrow));
+  glyphs.release(code);
+  glyphs.release(code);
+  CHECK_EQ(code, glyphs.acquire(arrow));
+  CHECK_EQ(before, panel.executed);
+  CHECK_EQ(1, glyphs.uploads());
+
+  // a copy of the bitmap is kept, not the caller's array
+  arrow[0] ^= 0x1F;
+  before = panel.executed;
+  uint8_t changed = glyphs.acquire(arrow);
+  CHECK(changed != code);
+  CHECK_EQ(9, panel.executed - before);
+  CHECK_EQ(2, glyphs.uploads());
+}
+
+TEST(lru_eviction)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  LiquidCrystalGlyphs glyphs(lcd);
+  uint8_t bitmap[8];
+  uint8_t codes[LCD_GLYPH_SLOTS];
+
+  lcd.begin(16, 2);
+  for (uint8_t i = 0; i < LCD_GLYPH_SLOTS; i++) {
+    pattern(i, bitmap);
+    codes[i] = glyphs.acquire(bitmap);
+    CHECK(codes[i] < LCD_GLYPH_SLOTS);
+  }
+  CHECK_EQ(LCD_GLYPH_SLOTS, glyphs.uploads());
+
+  // all 8 on screen: nothing can be evicted, and nothing is sent
+  unsigned long before = panel.executed;
+  pattern(100, bitmap);
+  CHECK_EQ(LCD_NO_GLYPH, glyphs.acquire(bitmap));
+  CHECK_EQ(before, panel.executed);
+
+  for (uint8_t i = 0; i < LCD_GLYPH_SLOTS; i++) {
+    glyphs.release(codes[i]);
+  }
+
+  // used again, glyph 0 is no longer the least recently used: glyph 1 is
+  pattern(0, bitmap);
+  CHECK_EQ(codes[0], glyphs.acquire(bitmap));
+  glyphs.release(codes[0]);
+
+  pattern(100, bitmap);
+  uint8_t code = glyphs.acquire(bitmap);
+  CHECK_EQ(codes[1], code);
+  CHECK_EQ(0, memcmp(bitmap, panel.glyph(code), 8));
+  CHECK_EQ(LCD_GLYPH_SLOTS + 1, glyphs.uploads());
+
+  // then glyph 2, and glyph 0 stays cached throughout
+  pattern(101, bitmap);
+  CHECK_EQ(codes[2], glyphs.acquire(bitmap));
+  pattern(0, bitmap);
+  CHECK_EQ(codes[0], glyphs.acquire(bitmap));
+  CHECK_EQ(LCD_GLYPH_SLOTS + 2, glyphs.uploads());
+
+  // glyphs 0-2 are on screen and, once 3-7 have been used, the least
+  // recently used: they are passed over
+  for (uint8_t i = 3; i < LCD_GLYPH_SLOTS; i++) {
+    pattern(i, bitmap);
+    CHECK_EQ(codes[i], glyphs.acquire(bitmap));
+    glyphs.release(codes[i]);
+  }
+  pattern(102, bitmap);
+  CHECK_EQ(codes[3], glyphs.acquire(bitmap));
+  pattern(1, bitmap);
+  CHECK_EQ(codes[4], glyphs.acquire(bitmap));
+}
+
+// bytes on the bus per widget update, against rewriting the text line
+TEST(bytes_per_update)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, EN, 8, 9, 10, 11);
+  LiquidCrystalGlyphs glyphs(lcd);
+  LiquidCrystalBar bar(lcd, glyphs, 6, 0, 10);
+  LiquidCrystalSparkline spark(lcd, glyphs, 12, 1, 4);
+
+  lcd.begin(16, 2);
+  unsigned long before = panel.executed;
+  lcd.setCursor(0, 0);
+  lcd.print("Fan Speed: 45   ");
+  unsigned long text = panel.executed - before;
+  CHECK_EQ(17, text);
+
+  // first draw: every cell, and the partial cell's glyph
+  before = panel.executed;
+  bar.draw(45, 100);
+  unsigned long first = panel.executed - before;
+  CHECK_EQ(9 + 1 + 10, first);
+  CHECK_STR("\xFF\xFF\xFF\xFF", panel.text(6, 4).c_str());
+
+  // one more column: the partial cell only, with a new glyph
+  before = panel.executed;
+  bar.draw(47, 100);
+  unsigned long step = panel.executed - before;
+  CHECK_EQ(9 + 1 + 1, step);
+
+  // back again: that glyph is still cached
+  before = panel.executed;
+  bar.draw(45, 100);
+  unsigned long cached = panel.executed - before;
+  CHECK_EQ(1 + 1, cached);
+
+  // unchanged: nothing
+  before = panel.executed;
+  bar.draw(45, 100);
+  CHECK_EQ(before, panel.executed);
+
+  // a full cell more: two cells
+  before = panel.executed;
+  bar.draw(55, 100);
+  unsigned long cell = panel.executed - before;
+  CHECK(cell <= 9 + 1 + 2);
+
+  // a sparkline sample changes the glyphs of its cells, not the text
+  for (int i = 0; i < 20; i++) {
+    spark.push(20 + i % 5);
+  }
+  spark.draw();
+  before = panel.executed;
+  spark.push(30);
+  spark.draw();
+  unsigned long sample = panel.executed - before;
+  CHECK(sample <= 4 * (9 + 2));
+
+  printf("bytes per update: text line %lu, bar first %lu, step %lu, cached %lu, cell %lu, sparkline %lu\n",
+         text, first, step, cached, cell, sample);
+  CHECK(cached < text);
+  CHECK(step < text);
+  CHECK_EQ(0, panel.overruns);
+}
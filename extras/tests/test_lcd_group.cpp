@@ -0,0 +1,168 @@
+#include <LiquidCrystal.h>
+#include <LiquidCrystalGroup.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+// three panels on one RS line and one set of D4..D7, each with its own
+// enable pin
+#define RS 6
+#define PANELS 3
+static const uint8_t enables[PANELS] = { 7, 12, 13 };
+
+#define QUEUE 40
+
+// setCursor() and 16 characters on both rows: 34 bytes
+static void refresh(LiquidCrystal& lcd, char tag)
+{
+  char line[17];
+
+  for (uint8_t row = 0; row < 2; row++) {
+    snprintf(line, sizeof(line), "panel %c row %u   ", tag, row);
+    lcd.setCursor(0, row);
+    lcd.print(line);
+  }
+}
+
+TEST(shared_lines)
+{
+  HD44780* panels[PANELS];
+  LiquidCrystal* lcds[PANELS];
+  uint16_t queues[PANELS][QUEUE];
+  LiquidCrystalGroup group;
+
+  for (uint8_t i = 0; i < PANELS; i++) {
+    panels[i] = new HD44780(RS, enables[i], 8, 9, 10, 11);
+    lcds[i] = new LiquidCrystal(RS, enables[i], 8, 9, 10, 11);
+    lcds[i]->begin(16, 2);
+    CHECK(group.add(*lcds[i], queues[i], QUEUE));
+  }
+
+  unsigned long before[PANELS];
+  for (uint8_t i = 0; i < PANELS; i++) {
+    before[i] = panels[i]->executed;
+    refresh(*lcds[i], 'A' + i);
+  }
+  group.flush();
+
+  // only the panel whose enable was strobed took each byte
+  for (uint8_t i = 0; i < PANELS; i++) {
+    char expected[17];
+    snprintf(expected, sizeof(expected), "panel %c row 1   ", 'A' + i);
+    CHECK_STR(expected, panels[i]->row(1).c_str());
+    CHECK_EQ(34, panels[i]->executed - before[i]);
+    CHECK_EQ(0, panels[i]->overruns);
+    CHECK_EQ(0, lcds[i]->queueStalls());
+  }
+
+  // clear() is queued like anything else and the 1.52 ms is waited out
+  lcds[0]->clear();
+  lcds[0]->print("after clear");
+  group.flush();
+  CHECK_STR("after clear     ", panels[0]->row(0).c_str());
+  CHECK_EQ(0, panels[0]->overruns);
+
+  for (uint8_t i = 0; i < PANELS; i++) {
+    delete lcds[i];
+    delete panels[i];
+  }
+}
+
+TEST(add_limits)
+{
+  LiquidCrystal* lcds[LCD_GROUP_MAX + 1];
+  uint16_t queues[LCD_GROUP_MAX + 1][QUEUE];
+  LiquidCrystalGroup group;
+
+  for (uint8_t i = 0; i <= LCD_GROUP_MAX; i++) {
+    lcds[i] = new LiquidCrystal(RS, 7, 8, 9, 10, 11);
+  }
+  CHECK(!group.add(*lcds[0], NULL, QUEUE));
+  CHECK(!group.add(*lcds[0], queues[0], 1));
+  for (uint8_t i = 0; i < LCD_GROUP_MAX; i++) {
+    CHECK(group.add(*lcds[i], queues[i], QUEUE));
+  }
+  CHECK(!group.add(*lcds[LCD_GROUP_MAX], queues[LCD_GROUP_MAX], QUEUE));
+  CHECK(group.poll());
+
+  for (uint8_t i = 0; i <= LCD_GROUP_MAX; i++) {
+    delete lcds[i];
+  }
+}
+
+// a display already in the group is turned away, and what it has queued
+// stays queued
+TEST(add_twice)
+{
+  HD44780 panel(RS, 7, 8, 9, 10, 11);
+  LiquidCrystal lcd(RS, 7, 8, 9, 10, 11);
+  uint16_t queue[QUEUE];
+  uint16_t other[QUEUE];
+  LiquidCrystalGroup group;
+
+  lcd.begin(16, 2);
+  CHECK(group.add(lcd, queue, QUEUE));
+  lcd.print("queued");
+  CHECK_EQ(6, lcd.queueDepth());
+
+  CHECK(!group.add(lcd, other, QUEUE));
+  CHECK(!group.add(lcd, queue, QUEUE));
+  CHECK_EQ(6, lcd.queueDepth());
+
+  group.flush();
+  CHECK_STR("queued          ", panel.row(0).c_str());
+  CHECK_EQ(0, panel.overruns);
+}
+
+// a full refresh of the three panels one after another with direct
+// writes, against the same refresh through a group
+TEST(throughput)
+{
+  HD44780* panels[PANELS];
+  LiquidCrystal* lcds[PANELS];
+  uint16_t queues[PANELS][QUEUE];
+  LiquidCrystalGroup group;
+
+  for (uint8_t i = 0; i < PANELS; i++) {
+    panels[i] = new HD44780(RS, enables[i], 8, 9, 10, 11);
+    lcds[i] = new LiquidCrystal(RS, enables[i], 8, 9, 10, 11);
+    lcds[i]->begin(16, 2);
+  }
+
+  host_time_t start = hostNow();
+  for (uint8_t i = 0; i < PANELS; i++) {
+    refresh(*lcds[i], 'A' + i);
+  }
+  host_time_t sequential = hostNow() - start;
+
+  // one panel alone through a group, then all three
+  CHECK(group.add(*lcds[0], queues[0], QUEUE));
+  start = hostNow();
+  refresh(*lcds[0], 'A');
+  group.flush();
+  host_time_t single = hostNow() - start;
+
+  for (uint8_t i = 1; i < PANELS; i++) {
+    CHECK(group.add(*lcds[i], queues[i], QUEUE));
+  }
+  start = hostNow();
+  for (uint8_t i = 0; i < PANELS; i++) {
+    refresh(*lcds[i], 'A' + i);
+  }
+  group.flush();
+  host_time_t grouped = hostNow() - start;
+
+  printf("3 panels: %u us one after another, %u us grouped (%u us for one)\n",
+         (unsigned)sequential, (unsigned)grouped, (unsigned)single);
+  CHECK(grouped * 3 <= sequential);
+  CHECK(grouped * 2 <= single * 3);
+
+  for (uint8_t i = 0; i < PANELS; i++) {
+    CHECK_EQ(0, panels[i]->overruns);
+    char expected[17];
+    snprintf(expected, sizeof(expected), "panel %c row 0   ", 'A' + i);
+    CHECK_STR(expected, panels[i]->row(0).c_str());
+    delete lcds[i];
+    delete panels[i];
+  }
+}
@@ -0,0 +1,165 @@
+#include <LiquidCrystal.h>
+#include <LiquidCrystalPCF8574.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+// A PCF8574 backpack: each byte of a transmission sets P0..P7, wired as
+// RS, RW, EN, backlight and D4..D7.  The bytes reach the port one by one,
+// ~90 us apart, and the controller latches on EN's falling edges.  All
+// pins switch at once, so RS, RW or data changing in the byte that raises
+// EN miss their setup time.
+class Backpack : public HostWireDevice {
+public:
+  Backpack(uint8_t address) : port(0), longest(0), setupViolations(0)
+  {
+    Wire.attach(address, this);
+  }
+
+  virtual void receive(const uint8_t *data, size_t length)
+  {
+    if (length > longest) {
+      longest = length;
+    }
+    // the transmission ends now; byte i went out (length - 1 - i) bytes ago
+    for (size_t i = 0; i < length; i++) {
+      host_time_t at = hostNow() - (length - 1 - i) * 90;
+      if (!(port & LCD_PCF8574_EN) && (data[i] & LCD_PCF8574_EN) &&
+          ((port ^ data[i]) & ~(LCD_PCF8574_EN | LCD_PCF8574_BACKLIGHT))) {
+        setupViolations++;
+      }
+      if ((port & LCD_PCF8574_EN) && !(data[i] & LCD_PCF8574_EN) && !(data[i] & LCD_PCF8574_RW)) {
+        lcd.latch(data[i] & LCD_PCF8574_RS, data[i] & 0xF0, at);
+      }
+      port = data[i];
+    }
+  }
+
+  bool backlightOn() const { return port & LCD_PCF8574_BACKLIGHT; }
+
+  HD44780 lcd;
+  uint8_t port;
+  size_t longest;   // bytes in the largest transmission
+  unsigned int setupViolations;
+};
+
+TEST(text_through_the_backpack)
+{
+  Wire.reset();
+  Backpack backpack(0x27);
+  LiquidCrystalPCF8574 transport(0x27);
+  LiquidCrystal lcd(transport);
+
+  lcd.begin(16, 2);
+  CHECK(!backpack.lcd.eightBit());
+  CHECK(backpack.lcd.twoLines());
+  CHECK(backpack.backlightOn());
+
+  lcd.print("Hello, world!");
+  lcd.setCursor(0, 1);
+  lcd.print("23.4 C  58 %");
+  CHECK_STR("Hello, world!   ", backpack.lcd.row(0).c_str());
+  CHECK_STR("23.4 C  58 %    ", backpack.lcd.row(1).c_str());
+
+  // the port writes alone are slow enough for the controller, and clear()
+  // waits out its 1.52 ms
+  lcd.clear();
+  lcd.print("again");
+  CHECK_STR("again           ", backpack.lcd.row(0).c_str());
+  CHECK_EQ(0, backpack.lcd.overruns);
+  CHECK_EQ(0, backpack.setupViolations);
+  CHECK(backpack.longest <= WIRE_BUFFER_LENGTH);
+  CHECK_EQ(Wire.transmissions(), transport.transactions());
+}
+
+// port writes for text written after a command ending in low nibble
+// previous: two per nibble, and one more before each nibble that changes
+// RS or the data lines
+static unsigned int portWrites(const char* text, uint8_t previous)
+{
+  unsigned int writes = 0;
+  uint8_t last = previous & 0x0F;   // RS low
+
+  for (const char* c = text; *c; c++) {
+    uint8_t nibbles[2] = { (uint8_t)(0x10 | (uint8_t)*c >> 4), (uint8_t)(0x10 | (*c & 0x0F)) };
+    for (int i = 0; i < 2; i++) {
+      writes += nibbles[i] == last ? 2 : 3;
+      last = nibbles[i];
+    }
+  }
+  return writes;
+}
+
+// a string goes out up to 32 port writes per transaction, instead of one
+// transaction per command or per pin change
+TEST(one_transaction_per_32_port_writes)
+{
+  Wire.reset();
+  Backpack backpack(0x27);
+  LiquidCrystalPCF8574 transport(0x27);
+  LiquidCrystal lcd(transport);
+
+  lcd.begin(16, 2);
+  lcd.setCursor(0, 0);
+
+  unsigned int before = Wire.transmissions();
+  unsigned long bytesBefore = Wire.bytes();
+  lcd.print("0123456789ABCDEF");
+  unsigned int writes = portWrites("0123456789ABCDEF", 0x80);
+  CHECK_EQ(3, Wire.transmissions() - before);
+  CHECK_EQ(3 + writes, Wire.bytes() - bytesBefore);
+  CHECK(backpack.longest > LCD_PCF8574_BUFFER - 3);
+  CHECK(backpack.longest <= LCD_PCF8574_BUFFER);
+
+  before = Wire.transmissions();
+  lcd.print("xyz");
+  CHECK_EQ(1, Wire.transmissions() - before);
+
+  // a command is a transaction of its own
+  before = Wire.transmissions();
+  lcd.setCursor(0, 1);
+  CHECK_EQ(1, Wire.transmissions() - before);
+  CHECK_EQ(0, backpack.lcd.overruns);
+  CHECK_EQ(0, backpack.setupViolations);
+}
+
+TEST(backlight)
+{
+  Wire.reset();
+  Backpack backpack(0x27);
+  LiquidCrystalPCF8574 transport(0x27);
+  LiquidCrystal lcd(transport);
+
+  lcd.begin(16, 2);
+  transport.noBacklight();
+  CHECK(!backpack.backlightOn());
+
+  // stays off while text is written
+  lcd.print("dark");
+  CHECK(!backpack.backlightOn());
+  CHECK_STR("dark", backpack.lcd.text(0, 4).c_str());
+
+  transport.backlight();
+  CHECK(backpack.backlightOn());
+}
+
+TEST(two_backpacks_on_one_bus)
+{
+  Wire.reset();
+  Backpack first(0x27);
+  Backpack second(0x3F);
+  LiquidCrystalPCF8574 firstTransport(0x27);
+  LiquidCrystalPCF8574 secondTransport(0x3F);
+  LiquidCrystal lcd(firstTransport);
+  LiquidCrystal lcd2(secondTransport);
+
+  lcd.begin(16, 2);
+  lcd2.begin(16, 2);
+  lcd.print("first");
+  lcd2.print("second");
+  CHECK_STR("first           ", first.lcd.row(0).c_str());
+  CHECK_STR("second          ", second.lcd.row(0).c_str());
+  CHECK_EQ(0, first.lcd.overruns + second.lcd.overruns);
+  CHECK_EQ(0, first.setupViolations + second.setupViolations);
+  CHECK_EQ(Wire.transmissions(), firstTransport.transactions() + secondTransport.transactions());
+}
@@ -0,0 +1,161 @@
+#include <string>
+
+#include <LiquidCrystal.h>
+#include <LiquidCrystalScheduler.h>
+
+#include "test.h"
+
+// render functions take no arguments, so they draw on these
+static LiquidCrystal* menuLcd;
+static LiquidCrystal* ambientLcd;
+static std::string rendered;
+
+// setCursor() and 5 characters: 480 us of bus time
+static void renderMenu()
+{
+  menuLcd->setCursor(0, 0);
+  menuLcd->print("> Fan");
+  rendered += 'M';
+}
+
+// both rows: 34 bytes, 2720 us
+static void renderAmbient()
+{
+  ambientLcd->setCursor(0, 0);
+  ambientLcd->print("Temp: 23.4 C    ");
+  ambientLcd->setCursor(0, 1);
+  ambientLcd->print("Humidity: 58 %  ");
+  rendered += 'A';
+}
+
+TEST(full_table)
+{
+  LiquidCrystal lcd(6, 7, 8, 9, 10, 11);
+  LiquidCrystalScheduler scheduler(10000);
+
+  menuLcd = &lcd;
+  rendered.clear();
+  for (uint8_t i = 0; i < LCD_SCHED_MAX; i++) {
+    CHECK_EQ(i, scheduler.add(lcd, renderMenu, 0, 0));
+  }
+  CHECK_EQ(LCD_SCHED_INVALID, scheduler.add(lcd, renderMenu, 0, 0));
+
+  // the id add() gave back for the display that didn't fit aliases none
+  uint8_t invalid = LCD_SCHED_INVALID;
+  scheduler.invalidate(invalid);
+  scheduler.invalidate(LCD_SCHED_MAX);
+  for (uint8_t i = 0; i < LCD_SCHED_MAX; i++) {
+    CHECK_EQ(0, scheduler.coalesced(i));
+  }
+  CHECK_EQ(0, scheduler.frames(invalid));
+  CHECK_EQ(0, scheduler.coalesced(invalid));
+  CHECK_EQ(0, scheduler.dropped(invalid));
+
+  // every display starts dirty
+  scheduler.run();
+  CHECK_STR("MMMM", rendered.c_str());
+}
+
+TEST(interval_and_coalescing)
+{
+  LiquidCrystal lcd(6, 7, 8, 9, 10, 11);
+  LiquidCrystalScheduler scheduler(1000);
+
+  ambientLcd = &lcd;
+  rendered.clear();
+  uint8_t id = scheduler.add(lcd, renderAmbient, 100, 0);
+  scheduler.run();
+  CHECK_EQ(1, scheduler.frames(id));
+
+  // three changes within the interval make one frame once it has passed
+  scheduler.invalidate(id);
+  scheduler.invalidate(id);
+  scheduler.invalidate(id);
+  CHECK_EQ(2, scheduler.coalesced(id));
+  scheduler.run();
+  hostAdvance(50000);
+  scheduler.run();
+  CHECK_EQ(1, scheduler.frames(id));
+
+  hostAdvance(50000);
+  scheduler.run();
+  CHECK_EQ(2, scheduler.frames(id));
+
+  // nothing changed: nothing drawn
+  hostAdvance(200000);
+  scheduler.run();
+  CHECK_EQ(2, scheduler.frames(id));
+  CHECK_STR("AA", rendered.c_str());
+  CHECK_EQ(0, scheduler.dropped(id));
+}
+
+TEST(priority_and_budget)
+{
+  LiquidCrystal menu(6, 7, 8, 9, 10, 11);
+  LiquidCrystal ambient(53, 52, 51, 50, 49, 48);
+  LiquidCrystalScheduler scheduler(1000);
+
+  menuLcd = &menu;
+  ambientLcd = &ambient;
+  rendered.clear();
+
+  // registered first, drawn last
+  uint8_t ambientId = scheduler.add(ambient, renderAmbient, 0, 0);
+  uint8_t menuId = scheduler.add(menu, renderMenu, 0, 2);
+
+  // the ambient frame's cost is not known yet, so both fit
+  scheduler.run();
+  CHECK_STR("MA", rendered.c_str());
+
+  // now it is (2720 us), and with the menu's 480 us it is over budget
+  scheduler.invalidate(ambientId);
+  scheduler.invalidate(menuId);
+  scheduler.run();
+  CHECK_STR("MAM", rendered.c_str());
+  CHECK_EQ(1, scheduler.dropped(ambientId));
+
+  // with the menu idle the first due display is drawn whatever its cost
+  scheduler.run();
+  CHECK_STR("MAMA", rendered.c_str());
+  CHECK_EQ(2, scheduler.frames(ambientId));
+  CHECK_EQ(2, scheduler.frames(menuId));
+  CHECK_EQ(0, scheduler.dropped(menuId));
+}
+
+// a frame that waits several passes is one dropped frame, not several
+TEST(dropped_counts_frames)
+{
+  LiquidCrystal menu(6, 7, 8, 9, 10, 11);
+  LiquidCrystal ambient(53, 52, 51, 50, 49, 48);
+  LiquidCrystalScheduler scheduler(1000);
+
+  menuLcd = &menu;
+  ambientLcd = &ambient;
+  rendered.clear();
+  uint8_t ambientId = scheduler.add(ambient, renderAmbient, 0, 0);
+  uint8_t menuId = scheduler.add(menu, renderMenu, 0, 2);
+  scheduler.run();
+
+  // the menu changes on every pass and keeps the ambient frame waiting
+  scheduler.invalidate(ambientId);
+  for (int pass = 0; pass < 3; pass++) {
+    scheduler.invalidate(menuId);
+    scheduler.run();
+  }
+  CHECK_STR("MAMMM", rendered.c_str());
+  CHECK_EQ(1, scheduler.dropped(ambientId));
+
+  scheduler.run();
+  CHECK_STR("MAMMMA", rendered.c_str());
+
+  // the next frame pushed back is counted again
+  scheduler.invalidate(ambientId);
+  scheduler.invalidate(menuId);
+  scheduler.run();
+  scheduler.invalidate(menuId);
+  scheduler.run();
+  scheduler.run();
+  CHECK_STR("MAMMMAMMA", rendered.c_str());
+  CHECK_EQ(2, scheduler.dropped(ambientId));
+  CHECK_EQ(0, scheduler.dropped(menuId));
+}
@@ -0,0 +1,80 @@
+#include <LiquidCrystal.h>
+#include <LiquidCrystalT.h>
+
+#include "HD44780.h"
+#include "test.h"
+
+// Off AVR the pins fall back to digitalWrite(), so the emulator sees the
+// same bus as on the board, only without the direct port writes.
+#define RS 6
+#define EN 7
+
+static uint8_t degree[8] = { 0x06, 0x09, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00 };
+
+template <class LCD>
+static void session(LCD& lcd)
+{
+  lcd.begin(16, 2);
+  lcd.createChar(1, degree);
+  lcd.setCursor(0, 0);
+  lcd.print("Temp: 23.4");
+  lcd.write((uint8_t)1);
+  lcd.print("C");
+  lcd.setCursor(0, 1);
+  lcd.print("Fan: 75%");
+  lcd.cursor();
+  lcd.blink();
+  lcd.rightToLeft();
+  lcd.print("<<");
+  lcd.leftToRight();
+}
+
+TEST(same_display_as_LiquidCrystal)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystalT<RS, EN, 8, 9, 10, 11> lcd;
+  session(lcd);
+
+  // powered up after LiquidCrystal's constructor has run begin(16, 1), so
+  // both controllers start from reset
+  LiquidCrystal lcdReference(RS, 12, 30, 31, 32, 33);
+  HD44780 reference(RS, 12, 30, 31, 32, 33);
+  session(lcdReference);
+
+  CHECK(!panel.eightBit());
+  CHECK(panel.twoLines());
+  CHECK_STR("Temp: 23.4\x01" "C    ", panel.row(0).c_str());
+  CHECK_STR(reference.row(0).c_str(), panel.row(0).c_str());
+  CHECK_STR(reference.row(1).c_str(), panel.row(1).c_str());
+  CHECK_EQ(0, memcmp(reference.glyph(1), panel.glyph(1), 8));
+  CHECK_EQ(0, memcmp(degree, panel.glyph(1), 8));
+  CHECK_EQ(reference.displayControl(), panel.displayControl());
+  CHECK_EQ(reference.entryMode(), panel.entryMode());
+  CHECK_EQ(reference.address(), panel.address());
+  CHECK_EQ(reference.executed, panel.executed);
+  CHECK_EQ(0, panel.overruns);
+}
+
+TEST(clear_and_home)
+{
+  HD44780 panel(RS, EN, 8, 9, 10, 11);
+  LiquidCrystalT<RS, EN, 8, 9, 10, 11> lcd;
+
+  lcd.begin(16, 2);
+  lcd.print("to be cleared");
+  lcd.clear();
+  lcd.print("x");
+  lcd.home();
+  lcd.print("y");
+  CHECK_STR("y               ", panel.row(0).c_str());
+  CHECK_EQ(0, panel.overruns);
+
+  // one line: setCursor() keeps to row 0
+  HD44780 single(RS, 12, 30, 31, 32, 33);
+  LiquidCrystalT<RS, 12, 30, 31, 32, 33> oneLine;
+  oneLine.begin(8, 1);
+  CHECK(!single.twoLines());
+  oneLine.setCursor(2, 1);
+  oneLine.print("ab");
+  CHECK_STR("  ab", single.text(0, 4).c_str());
+}
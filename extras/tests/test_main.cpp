@@ -0,0 +1,25 @@
+#include "test.h"
+
+TestCase *testHead = NULL;
+TestCase **testTail = &testHead;
+int testFailures = 0;
+
+int main()
+{
+  int tests = 0;
+
+  for (TestCase *test = testHead; test != NULL; test = test->next) {
+    int before = testFailures;
+
+    // every test starts at time 0 on a fresh board
+    hostReset();
+    test->fn();
+    tests++;
+    if (testFailures != before) {
+      printf("FAILED %s\n", test->name);
+    }
+  }
+
+  printf("%d tests, %d failed checks\n", tests, testFailures);
+  return testFailures == 0 ? 0 : 1;
+}